@@ -0,0 +1,442 @@
+// spectra_bench: times every stage of the analysis pipeline for each FFT size
+// in both precisions and prints the results as JSON. Exits non-zero if packed and
+// unpacked stereo analysis disagree beyond rounding.
+//
+//   spectra_bench [--label NAME] [--out FILE] [--min-time SECONDS]
+
+#include "Config.h"
+#include "RingBuffer.h"
+#include "Deinterleave.h"
+#include "FFTWindow.h"
+#include "Kernels.h"
+#include "LogAnalyzer.h"
+#include "MultiResolutionAnalyzer.h"
+#include "SlidingDFT.h"
+#include "GoertzelBank.h"
+
+#include <pffft.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Stereo, the common capture case
+static constexpr uint32_t BENCH_CHANNEL_COUNT{ 2 };
+
+struct Options {
+    std::string label{};
+    std::string outputPath{};
+    double      minTime{ 0.05 };
+};
+
+struct Parity {
+    const char* type{};
+    uint32_t    fftSize{};
+    double      maxAbsError{};
+    double      maxRelError{};
+    bool        isPassed{};
+};
+
+struct Result {
+    const char* type{};
+    uint32_t    fftSize{};
+    const char* stage{};
+    double      nsPerCall{};
+    double      nsPerSample{};
+    uint64_t    iterations{};
+};
+
+// The Goertzel bank's cost as a fraction of one FFT's: per frame, and per second of input
+// at the same overlap, i.e. the share of the FFT path's CPU it needs
+struct BankRatio {
+    const char* type{};
+    uint32_t    fftSize{};
+    uint32_t    blockSize{};
+    double      perFrame{};
+    double      perSample{};
+};
+
+template <typename T>
+struct TypeName;
+template <> struct TypeName<float> { static constexpr const char* value{ "float" }; };
+template <> struct TypeName<double> { static constexpr const char* value{ "double" }; };
+
+// Largest packed/unpacked stereo difference, relative to the spectrum's peak, that is still rounding
+template <typename T>
+struct ParityTolerance;
+template <> struct ParityTolerance<float> { static constexpr double value{ 1e-5 }; };
+template <> struct ParityTolerance<double> { static constexpr double value{ 1e-12 }; };
+
+// Keeps the optimizer from discarding a stage's output
+template <typename T>
+inline void Consume(const T* data)
+{
+    static volatile T sink{};
+    sink = sink + data[0];
+}
+
+template <typename T>
+inline void Consume(const std::complex<T>* data)
+{
+    Consume(&reinterpret_cast<const T(&)[2]>(data[0])[0]);
+}
+
+// Median over several batches, each long enough to cover timer resolution
+template <typename F>
+std::pair<double, uint64_t> Measure(F&& stage, double minTime)
+{
+    using Clock = std::chrono::steady_clock;
+    static constexpr uint32_t BATCH_COUNT{ 7 };
+
+    uint64_t iterations{ 1 };
+    for (;;) {
+        const auto start{ Clock::now() };
+        for (uint64_t i{}; i < iterations; ++i)
+            stage();
+        const double elapsed{ std::chrono::duration<double>(Clock::now() - start).count() };
+        if (elapsed >= minTime / BATCH_COUNT)
+            break;
+        iterations *= 2;
+    }
+
+    std::vector<double> samples{};
+    for (uint32_t batch{}; batch < BATCH_COUNT; ++batch) {
+        const auto start{ Clock::now() };
+        for (uint64_t i{}; i < iterations; ++i)
+            stage();
+        samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations);
+    }
+    std::nth_element(samples.begin(), samples.begin() + BATCH_COUNT / 2, samples.end());
+    return { samples[BATCH_COUNT / 2], iterations * BATCH_COUNT };
+}
+
+template <typename T>
+void BenchSize(uint32_t fftSize, const Options& options, std::vector<Result>& results, std::vector<Parity>& parities)
+{
+    const uint32_t resultSize{ fftSize / 2 };
+    std::mt19937 rng{ fftSize };
+    std::uniform_real_distribution<float> dist{ -1.f, 1.f };
+
+    // Captured audio as the device delivers it, one FFT worth of stereo frames
+    std::vector<float> interleaved(fftSize * BENCH_CHANNEL_COUNT);
+    for (auto& s : interleaved)
+        s = dist(rng);
+
+    // Offset the ring so the window read straddles the wrap point, as it usually does
+    RingBuffer<T> ring{ BENCH_CHANNEL_COUNT, SAMPLE_RING_SIZE };
+    const uint32_t wrapOffset{ SAMPLE_RING_SIZE - fftSize / 2 };
+    ring.EndWrite(ring.BeginWrite(wrapOffset).first);
+
+    pffft::Fft<T> fft{ static_cast<int>(fftSize) };
+    auto fftIn{ fft.valueVector() };
+    auto fftOut{ fft.spectrumVector() };
+    const auto windowTable{ GetWindow<T>(WindowType::BLACKMAN_HARRIS, fftSize) };
+    const auto& window{ *windowTable };
+
+    std::vector<T> magnitudes(resultSize), peaks(resultSize);
+
+    const auto record = [&](const char* stage, auto&& fn, uint32_t samples) {
+        const auto [ns, iterations] { Measure(fn, options.minTime) };
+        results.push_back({ TypeName<T>::value, fftSize, stage, ns, ns / samples, iterations });
+    };
+
+    record("deinterleave", [&] {
+        const auto region{ ring.BeginWrite(fftSize) };
+        T* dst[BENCH_CHANNEL_COUNT]{};
+        for (uint32_t channel{}; channel < BENCH_CHANNEL_COUNT; ++channel)
+            dst[channel] = ring.Data(channel) + region.offset;
+        ::Deinterleave(interleaved.data(), BENCH_CHANNEL_COUNT, dst, region.first);
+        for (uint32_t channel{}; channel < BENCH_CHANNEL_COUNT; ++channel)
+            dst[channel] = ring.Data(channel);
+        ::Deinterleave(interleaved.data() + region.first * BENCH_CHANNEL_COUNT, BENCH_CHANNEL_COUNT, dst, region.second);
+        // Leave the write position where it was so every iteration hits the wrap
+    }, fftSize * BENCH_CHANNEL_COUNT);
+    ring.EndWrite(fftSize);
+
+    const uint64_t end{ ring.WriteSequence() };
+    record("window", [&] {
+        ::ApplyWindow<T>(ring.Peek(CHANNEL_LEFT, end, fftSize), window.data(), fftIn.data());
+        Consume(fftIn.data());
+    }, fftSize);
+
+    record("fft", [&] {
+        fft.forward(fftIn, fftOut);
+        Consume(fftOut.data());
+    }, fftSize);
+
+    record("magnitude_power", [&] {
+        ::ComputeMagnitudes(fftOut.data(), magnitudes.data(), resultSize, MagnitudeMode::POWER);
+        Consume(magnitudes.data());
+    }, resultSize);
+
+    record("magnitude_fast", [&] {
+        ::ComputeMagnitudes(fftOut.data(), magnitudes.data(), resultSize, MagnitudeMode::FAST);
+        Consume(magnitudes.data());
+    }, resultSize);
+
+    // Last, so the peak stage below sees exact magnitudes
+    record("magnitude", [&] {
+        ::ComputeMagnitudes(fftOut.data(), magnitudes.data(), resultSize, MagnitudeMode::EXACT);
+        Consume(magnitudes.data());
+    }, resultSize);
+
+    record("peak", [&] {
+        ::UpdatePeaks(magnitudes.data(), peaks.data(), resultSize, T(.99));
+        Consume(peaks.data());
+    }, resultSize);
+
+    // The log-frequency analyzer fed the same block, at its default resolution and 50% overlap
+    LogAnalyzer<T> logAnalyzer{ DEFAULT_SAMPLE_RATE, DEFAULT_BINS_PER_OCTAVE };
+    const auto logWindow{ GetWindow<T>(WindowType::BLACKMAN_HARRIS, logAnalyzer.GetFFTSize()) };
+    std::vector<T> logMagnitudes(logAnalyzer.GetResultSize());
+    record("log_frequency", [&] {
+        const auto [first, second] { ring.Peek(CHANNEL_LEFT, end, fftSize) };
+        logAnalyzer.Push(first.data, first.size);
+        logAnalyzer.Push(second.data, second.size);
+        logAnalyzer.Analyze(0, logWindow, logAnalyzer.GetFFTSize() / 2, MagnitudeMode::EXACT, logMagnitudes.data());
+        Consume(logMagnitudes.data());
+    }, fftSize);
+
+    // One multi-resolution hop with this FFT size as the bass resolution: the new input
+    // through the decimators, then every band, on one thread. Smaller sizes are clamped
+    // up to MIN_FFT_SIZE, so they would only repeat that row under another label.
+    if (fftSize >= MultiResolutionAnalyzer<T>::MIN_FFT_SIZE) {
+        MultiResolutionAnalyzer<T> multiAnalyzer{ fftSize };
+        const auto bands{ MultiResolutionAnalyzer<T>::GetBands(fftSize) };
+        std::vector<std::shared_ptr<const FFTValueVector<T>>> bandWindows{};
+        for (const auto& band : bands)
+            bandWindows.push_back(GetWindow<T>(WindowType::BLACKMAN_HARRIS, band.fftSize));
+        const uint32_t multiHop{ bands.back().fftSize / 2 };
+        std::vector<T> multiMagnitudes(multiAnalyzer.GetResultSize());
+        record("multi_resolution", [&] {
+            const auto [first, second] { ring.Peek(CHANNEL_LEFT, end, multiHop) };
+            multiAnalyzer.Push(first.data, first.size);
+            multiAnalyzer.Push(second.data, second.size);
+            for (uint32_t band{}; band < multiAnalyzer.GetTaskCount(); ++band)
+                multiAnalyzer.Analyze(band, bandWindows[band], multiHop, MagnitudeMode::EXACT, multiMagnitudes.data());
+            Consume(multiMagnitudes.data());
+        }, fftSize);
+    }
+
+    // One sliding DFT hop at this window length: slide the new samples through every
+    // tracked bin, then read the targets
+    SlidingDFT<T> slidingDFT{ DEFAULT_SAMPLE_RATE, fftSize, DEFAULT_BINS_PER_OCTAVE };
+    const uint32_t slidingHop{ SlidingDFT<T>::HOP_SIZE_BASE / 2 };
+    std::vector<T> slidingMagnitudes(slidingDFT.GetResultSize());
+    record("sliding_dft", [&] {
+        const auto [first, second] { ring.Peek(CHANNEL_LEFT, end, slidingHop) };
+        slidingDFT.Push(first.data, first.size);
+        slidingDFT.Push(second.data, second.size);
+        slidingDFT.Analyze(0, windowTable, slidingHop, MagnitudeMode::EXACT, slidingMagnitudes.data());
+        Consume(slidingMagnitudes.data());
+    }, slidingHop);
+
+    // Full window/FFT/magnitude for a stereo pair: two real transforms vs. one packed complex one
+    pffft::Fft<std::complex<T>> packedFFT{ static_cast<int>(fftSize) };
+    auto packedIn{ packedFFT.valueVector() };
+    auto packedOut{ packedFFT.spectrumVector() };
+    std::array<std::vector<T>, 2> realMags{ std::vector<T>(resultSize), std::vector<T>(resultSize) };
+    std::array<std::vector<T>, 2> packedMags{ std::vector<T>(resultSize), std::vector<T>(resultSize) };
+
+    record("stereo_real", [&] {
+        for (uint32_t channel{}; channel < 2; ++channel) {
+            ::ApplyWindow<T>(ring.Peek(channel, end, fftSize), window.data(), fftIn.data());
+            fft.forward(fftIn, fftOut);
+            ::ComputeMagnitudes(fftOut.data(), realMags[channel].data(), resultSize, MagnitudeMode::EXACT);
+        }
+        Consume(realMags[1].data());
+    }, fftSize * 2);
+
+    record("stereo_packed", [&] {
+        ::ApplyWindowPacked<T>(ring.Peek(CHANNEL_LEFT, end, fftSize), ring.Peek(CHANNEL_RIGHT, end, fftSize), 
+                               window.data(), packedIn.data());
+        packedFFT.forward(packedIn, packedOut);
+        ::SplitPackedMagnitudes(packedOut.data(), fftSize, packedMags[0].data(), packedMags[1].data(), MagnitudeMode::EXACT);
+        Consume(packedMags[1].data());
+    }, fftSize * 2);
+
+    // Both paths must agree to within rounding of the larger transform
+    Parity parity{ TypeName<T>::value, fftSize };
+    for (uint32_t channel{}; channel < 2; ++channel) {
+        const T peak{ *std::max_element(realMags[channel].begin(), realMags[channel].end()) };
+        for (uint32_t i{}; i < resultSize; ++i) {
+            const double error{ std::abs(static_cast<double>(realMags[channel][i]) - packedMags[channel][i]) };
+            parity.maxAbsError = std::max(parity.maxAbsError, error);
+            parity.maxRelError = std::max(parity.maxRelError, error / std::max<double>(peak, 1e-30));
+        }
+    }
+    parity.isPassed = parity.maxRelError <= ParityTolerance<T>::value;
+    parities.push_back(parity);
+}
+
+// The Goertzel bank over one block for its default targets. Its block length does not
+// depend on the FFT size, so it is timed once; the samples need no window for that.
+template <typename T>
+Result BenchGoertzelBank(const Options& options)
+{
+    const auto frequencies{ GoertzelBank<T>::GetDefaultFrequencies() };
+    const uint32_t blockSize{ GoertzelBank<T>::GetBlockSize(DEFAULT_SAMPLE_RATE, frequencies) };
+    const GoertzelBank<T> bank{ DEFAULT_SAMPLE_RATE, frequencies };
+
+    std::mt19937 rng{ blockSize };
+    std::uniform_real_distribution<float> dist{ -1.f, 1.f };
+    std::vector<T> block(blockSize);
+    for (auto& s : block)
+        s = dist(rng);
+
+    std::vector<T> magnitudes(bank.GetSize());
+    const auto [ns, iterations] { Measure([&] {
+        bank.Process(block.data(), blockSize, MagnitudeMode::EXACT, magnitudes.data());
+        Consume(magnitudes.data());
+    }, options.minTime) };
+    return { TypeName<T>::value, blockSize, "goertzel_bank", ns, ns / blockSize, iterations };
+}
+
+template <typename T>
+void BenchType(const Options& options, std::vector<Result>& results, std::vector<Parity>& parities,
+               std::vector<BankRatio>& bankRatios)
+{
+    const size_t first{ results.size() };
+    for (uint32_t fftSize{ 128 }; fftSize <= MAX_FFT_SIZE; fftSize *= 2)
+        BenchSize<T>(fftSize, options, results, parities);
+
+    const Result bank{ BenchGoertzelBank<T>(options) };
+    for (size_t i{ first }; i < results.size(); ++i) {
+        const auto& r{ results[i] };
+        if (!std::strcmp(r.stage, "fft"))
+            bankRatios.push_back({ r.type, r.fftSize, bank.fftSize, bank.nsPerCall / r.nsPerCall, bank.nsPerSample / r.nsPerSample });
+    }
+    results.push_back(bank);
+}
+
+std::string Escape(const std::string& s)
+{
+    std::string escaped{};
+    for (const char c : s) {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+const char* SimdName()
+{
+#if defined(SP_SIMD_AVX2)
+    return "AVX2";
+#elif defined(SP_SIMD_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+const char* CompilerName()
+{
+#if defined(_MSC_VER)
+    return "msvc " SP_STRINGIFY(_MSC_VER);
+#elif defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#else
+    return "unknown";
+#endif
+}
+
+void WriteJson(std::ostream& os, const Options& options, const std::vector<Result>& results, const std::vector<Parity>& parities,
+               const std::vector<BankRatio>& bankRatios)
+{
+    os << "{\n"
+       << "  \"label\": \"" << Escape(options.label) << "\",\n"
+       << "  \"machine\": {\n"
+       << "    \"simd\": \"" << SimdName() << "\",\n"
+       << "    \"pffftSimd\": " << pffft::Fft<float>::simd_size() << ",\n"
+       << "    \"compiler\": \"" << Escape(CompilerName()) << "\",\n"
+       << "    \"threads\": " << std::thread::hardware_concurrency() << "\n"
+       << "  },\n"
+       << "  \"results\": [\n";
+    for (size_t i{}; i < results.size(); ++i) {
+        const auto& r{ results[i] };
+        os << "    { \"type\": \"" << r.type << "\", \"fftSize\": " << r.fftSize
+           << ", \"stage\": \"" << r.stage << "\", \"nsPerCall\": " << r.nsPerCall
+           << ", \"nsPerSample\": " << r.nsPerSample << ", \"iterations\": " << r.iterations << " }"
+           << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    os << "  ],\n"
+       << "  \"stereoPackingParity\": [\n";
+    for (size_t i{}; i < parities.size(); ++i) {
+        const auto& p{ parities[i] };
+        os << "    { \"type\": \"" << p.type << "\", \"fftSize\": " << p.fftSize
+           << ", \"maxAbsError\": " << p.maxAbsError << ", \"maxRelError\": " << p.maxRelError
+           << ", \"passed\": " << (p.isPassed ? "true" : "false") << " }"
+           << (i + 1 < parities.size() ? ",\n" : "\n");
+    }
+    os << "  ],\n"
+       << "  \"goertzelBankVsFFT\": [\n";
+    for (size_t i{}; i < bankRatios.size(); ++i) {
+        const auto& r{ bankRatios[i] };
+        os << "    { \"type\": \"" << r.type << "\", \"fftSize\": " << r.fftSize << ", \"blockSize\": " << r.blockSize
+           << ", \"perFrame\": " << r.perFrame << ", \"perSample\": " << r.perSample << " }"
+           << (i + 1 < bankRatios.size() ? ",\n" : "\n");
+    }
+    os << "  ]\n}\n";
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    Options options{};
+    for (int i{ 1 }; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--label") && i + 1 < argc)
+            options.label = argv[++i];
+        else if (!std::strcmp(argv[i], "--out") && i + 1 < argc)
+            options.outputPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--min-time") && i + 1 < argc)
+            options.minTime = std::stod(argv[++i]);
+        else {
+            std::cerr << "Usage: spectra_bench [--label NAME] [--out FILE] [--min-time SECONDS]\n";
+            return 1;
+        }
+    }
+
+    std::vector<Result> results{};
+    std::vector<Parity> parities{};
+    std::vector<BankRatio> bankRatios{};
+    BenchType<float>(options, results, parities, bankRatios);
+    BenchType<double>(options, results, parities, bankRatios);
+
+    if (options.outputPath.empty()) {
+        WriteJson(std::cout, options, results, parities, bankRatios);
+    }
+    else {
+        std::ofstream out{ options.outputPath };
+        WriteJson(out, options, results, parities, bankRatios);
+        if (!out) {
+            std::cerr << "Could not write " << options.outputPath << '\n';
+            return 1;
+        }
+    }
+
+    int status{};
+    for (const auto& p : parities) {
+        if (!p.isPassed) {
+            std::cerr << "Stereo packing parity failed: " << p.type << " at FFT size " << p.fftSize
+                      << ", relative error " << p.maxRelError << '\n';
+            status = 1;
+        }
+    }
+    return status;
+}
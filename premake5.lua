@@ -1,3 +1,8 @@
+newoption {
+    trigger = "avx2",
+    description = "Build the SIMD kernels for AVX2 instead of SSE2"
+}
+
 workspace "spectra"
     architecture "x64"
     startproject "spectra"
@@ -29,6 +34,41 @@ workspace "spectra"
         }
     group ""
 
+    project "SpectrumEngine"
+        kind "StaticLib"
+        language "C++"
+        cppdialect "C++17"
+        targetdir "bin/%{prj.name}/%{cfg.buildcfg}"
+        objdir "obj/%{prj.name}/%{cfg.buildcfg}"
+        staticruntime "on"
+
+        links {
+            "pffft"
+        }
+
+        includedirs {
+            "%{IncDir.pffft}",
+            "src",
+            "src/Engine"
+        }
+
+        files { 
+            "src/Engine/**.cpp",
+            "src/Engine/**.h"
+        }
+
+        filter "options:avx2"
+            vectorextensions "AVX2"
+
+        filter "system:windows"
+            systemversion "latest"
+
+        filter "configurations:Debug"
+            symbols "on"
+
+        filter "configurations:Release"
+            optimize "on"
+
     project "spectra"
         -- kind "WindowedApp"
         kind "ConsoleApp"
@@ -39,12 +79,12 @@ workspace "spectra"
         staticruntime "on"
 
         links {
+            "SpectrumEngine",
             "glad",
             "glfw",
             "imgui",
             "pffft",
-            "implot",
-            "opengl32.lib"
+            "implot"
         }
 
         includedirs {
@@ -55,6 +95,7 @@ workspace "spectra"
             "%{IncDir.implot}",
             "%{IncDir.spline}",
             "src",
+            "src/Engine",
             "3rdparty/miniaudio"
         }
 
@@ -62,16 +103,65 @@ workspace "spectra"
             "src/**.cpp",
             "src/**.h"
         }
+
+        removefiles {
+            "src/Engine/**"
+        }
 		
 		defines {
-			"SP_USE_F64",
             -- "SP_ENALBE_INTERPOLATION",
             -- "SP_NO_CONSOLE",
 			"IMGUI_USER_CONFIG=\"ImGuiConfig.h\""
 		}
 
+        filter "options:avx2"
+            vectorextensions "AVX2"
+
         filter "system:windows"
             systemversion "latest"
+            links { "opengl32.lib" }
+
+        filter "system:linux"
+            links { "GL", "pthread", "dl" }
+
+        filter "configurations:Debug"
+            symbols "on"
+
+        filter "configurations:Release"
+            optimize "on"
+
+    project "spectra_bench"
+        kind "ConsoleApp"
+        language "C++"
+        cppdialect "C++17"
+        targetdir "bin/%{prj.name}/%{cfg.buildcfg}"
+        objdir "obj/%{prj.name}/%{cfg.buildcfg}"
+        staticruntime "on"
+
+        links {
+            "SpectrumEngine",
+            "pffft"
+        }
+
+        includedirs {
+            "%{IncDir.pffft}",
+            "src",
+            "src/Engine"
+        }
+
+        files { 
+            "bench/**.cpp",
+            "bench/**.h"
+        }
+
+        filter "options:avx2"
+            vectorextensions "AVX2"
+
+        filter "system:windows"
+            systemversion "latest"
+
+        filter "system:linux"
+            links { "pthread" }
 
         filter "configurations:Debug"
             symbols "on"
@@ -1,7 +1,8 @@
 #include "Application.h"
 #include "Utils.h"
-
-#include "FFTWindow.h"
+#include "OfflineAnalysis.h"
+#include "SpectrumRenderer.h"
+#include "WaterfallRenderer.h"
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -18,59 +19,8 @@
 
 void Application::AudioDataCallback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount)
 {
-	const auto samples{ static_cast<const float*>(pInput) };
 	auto app{ static_cast<Application*>(pDevice->pUserData) };
-
-    {
-        std::lock_guard l{ app->sampleBufferMutex };
-		for (uint32_t i{}; i < frameCount; ++i, ++app->writePtr) {
-			app->writePtr %= app->sampleBufferSize;
-			app->sampleBuffer[CHANNEL_LEFT][app->writePtr] = samples[2 * i];
-			app->sampleBuffer[CHANNEL_RIGHT][app->writePtr] = samples[2 * i + 1]; 
-        }
-
-		auto readPtr{ static_cast<int64_t>(app->writePtr) - frameCount };
-		if (readPtr < 0) 
-			readPtr += app->sampleBufferSize;
-		app->readPtr = readPtr;
-    }
-
-	app->sampleAvailCond.notify_all();
-}
-
-void Application::FFTWorker(Application* app)
-{
-	auto fftIn{ app->fftInstance->valueVector() };
-	auto fftOut{ app->fftInstance->spectrumVector() };
-
-    while (app->isRunning) {
-        std::unique_lock lock{ app->sampleAvailMutex };
-        app->sampleAvailCond.wait(lock);
-
-        for (uint32_t channel{}; channel < CHANNEL_COUNT; ++channel) {
-            {
-                std::lock_guard l{ app->sampleBufferMutex };
-                for (uint32_t i{}, rdptr{ app->readPtr }; i < app->fftSize; ++i, ++rdptr) {
-					rdptr %= app->sampleBufferSize;
-					fftIn[i] = app->sampleBuffer[channel][rdptr] * app->fftWindow[i];
-				}
-            }
-
-			{
-				std::lock_guard l{ app->fftBusyMutex };
-				app->fftInstance->forward(fftIn, fftOut);
-			}
-
-			{
-                std::lock_guard l{ app->drawBufferMutex };
-				for (uint32_t i{}; i < app->fftResultSize; ++i) {
-                    SP_FLOAT mag{ std::abs(fftOut[i]) };
-                    app->heights[channel][i] = std::max(mag, app->thresholds[channel][i]);
-					app->thresholds[channel][i] = std::max(mag, app->thresholds[channel][i]);
-				}
-            }
-        }
-    }
+	app->engine->PushSamples(static_cast<const float*>(pInput), frameCount);
 }
 
 Application::Application()
@@ -84,115 +34,91 @@ Application::Application()
 				 {  GLFW_DECORATED, true }});
   
 	InitImGui();
-	ResetFFT(MAX_FFT_SIZE);
 	InitAudioDevice();
-	fftThread = std::thread{ FFTWorker, this };
+
+	renderer = std::make_unique<SpectrumRenderer>(engine->GetChannelCount());
+	waterfall = std::make_unique<WaterfallRenderer>();
+	engine->SetPlotCallback([this](const auto& frame) { OnPlot(frame); });
+	engine->Start();
 }
 
 Application::~Application()
 {
-	isRunning = false;
-	fftThread.join();
 	DeInitAudioDevice();
+	engine->Stop();
+	renderer.reset();
+	waterfall.reset();
 	glfwTerminate();
 }
 
 int32_t Application::Run()
 {
-    static SP_TIMEPOINT lastTime{ SP_TIME_NOW() };
-    static constexpr float TIME_STEP{ 1.f / 60 };
-
+    SP_TIMEPOINT lastFrame{ SP_TIME_NOW() };
     while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
+        // Input, or OnPlot posting an empty event, ends the wait
+        if (isEventDriven)
+            glfwWaitEventsTimeout(IDLE_REDRAW_INTERVAL);
+        else
+            glfwPollEvents();
+
+        // Events arriving before the cap allows a frame are still handled, just not drawn
+        if (fpsCap > 0) {
+            const double interval{ 1. / fpsCap };
+            for (double elapsed{ SP_TIME_DELTA(lastFrame) }; elapsed < interval; elapsed = SP_TIME_DELTA(lastFrame))
+                glfwWaitEventsTimeout(interval - elapsed);
+        }
+        lastFrame = SP_TIME_NOW();
+        isFramePending.store(false);
+
 		ImGuiBeginFrame();
 
 		auto io{ ImGui::GetIO() };
 		ImGui::SetNextWindowPos(ImVec2(0, 0));
 		ImGui::SetNextWindowSize(io.DisplaySize);
-		ImGui::Begin("Canvas", nullptr, ImGuiWindowFlags_NoInputs | ImGuiWindowFlags_NoTitleBar);
+		ImGui::Begin("Canvas", nullptr, ImGuiWindowFlags_NoInputs | ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoBackground);
 
         if (ImGui::IsKeyPressed(ImGuiKey_Escape))
             glfwSetWindowShouldClose(window, GLFW_TRUE);
 
-        const SP_FLOAT deltaTime{ SP_TIME_DELTA(lastTime) };
-        lastTime = SP_TIME_NOW();
-
         const auto min{ ImGui::GetWindowContentRegionMin() };
         const auto max{ ImGui::GetWindowContentRegionMax() };
         const auto size = max - min;
 
-        static auto colorL{ ImPlot::GetColormapColor(0) };
-        static auto colorR{ ImPlot::GetColormapColor(1) };
+        const uint32_t channelCount{ engine->GetChannelCount() };
+        const auto channelName = [channelCount](uint32_t channel) {
+            if (channelCount == 2)
+                return std::string{ channel == CHANNEL_LEFT ? "L" : "R" };
+            return std::to_string(channel + 1);
+        };
+
+        static std::vector<ImVec4> channelColors{};
+        for (auto i{ static_cast<uint32_t>(channelColors.size()) }; i < channelCount; ++i)
+            channelColors.push_back(ImPlot::GetColormapColor(i));
         static float lineWidth{ 1.f };
         static float shadeTransparency{ .5f };
         static bool drawOrder{};
-        static int scaleType{};
         static bool keepTitleBar{};
         static bool syncChannelAlpha{};
+        static bool showWaterfall{};
 
         {
-			std::lock_guard lock{ drawBufferMutex };
-
-            // Fixed timestep update
-            static SP_FLOAT accumulator{};
-            accumulator += deltaTime;
-            while (accumulator >= TIME_STEP) {
-                for (uint32_t channel{}; channel < CHANNEL_COUNT; ++channel) {
-                    for (uint32_t i{}; i < fftResultSize; ++i)
-                        thresholds[channel][i] /= std::max(SP_EXP(thresholds[channel][i]), SP_FLOAT(1.01));
-                }
-                accumulator -= TIME_STEP;
-            }
-
-            // spline
-#if SP_DO_SPLINE_INTERPOLATION
-            std::vector<double> xv(xs, xs + SP_ARRAY_SIZE(xs));
-            std::vector<std::vector<double>> yvs;
-            for (uint32_t i = 0; i < CHANNEL_COUNT; ++i)
-                yvs.push_back(std::vector<double>(heights[i], heights[i] + SP_ARRAY_SIZE(heights[i])));
-
-            std::vector<tk::spline> splines;
-            for (uint32_t i = 0; i < CHANNEL_COUNT; ++i)
-                splines.emplace_back(xv, yvs[i]);
-
-            for (auto& h : g.heights) {
-                for (uint32_t i{}; i < h.size(); ++i)
-                    h[i] = h[i] * g.resultScale + g.resultOffset;
-            }
-#endif
-
-            // Plot    
-            ImPlot::PushStyleVar(ImPlotStyleVar_PlotPadding, ImVec2(0, 0));
-            if (ImPlot::BeginPlot("FFT", size, ImPlotFlags_CanvasOnly)) {
-                ImPlot::SetupAxes(nullptr, nullptr, ImPlotAxisFlags_NoTickLabels, ImPlotAxisFlags_NoTickLabels);
-                ImPlot::SetupAxisScale(ImAxis_X1, ImPlotScale_Log10);
-                ImPlot::SetupAxisScale(ImAxis_Y1, ImPlotScale_Log10);
-                ImPlot::SetupAxesLimits(1, xs.size(), 0.001, 100, ImPlotCond_Always);
-                ImPlot::PushStyleVar(ImPlotStyleVar_FillAlpha, shadeTransparency);
-
-                auto plot = [&](const char* label, 
-                                const std::vector<SP_FLOAT>& xs, 
-                                const std::vector<SP_FLOAT>& ys, 
-                                ImVec4 color) {
-                    ImPlot::PushStyleColor(ImPlotCol_Line, color);
-                    ImPlot::PushStyleColor(ImPlotCol_Fill, color);
-                    ImPlot::PlotShaded(label, xs.data(), ys.data(), xs.size());
-                    ImPlot::SetNextLineStyle(color, lineWidth);
-                    ImPlot::PlotLine(label, xs.data(), ys.data(), xs.size());
-                    ImPlot::PopStyleColor(2);
-                };
-
-                if (drawOrder) {
-                    plot("L", xs, heights[CHANNEL_LEFT], colorL);
-                    plot("R", xs, heights[CHANNEL_RIGHT], colorR);
-                }
-                else {
-                    plot("R", xs, heights[CHANNEL_RIGHT], colorR);
-                    plot("L", xs, heights[CHANNEL_LEFT], colorL);
-                }
-                ImPlot::EndPlot();
-            }
-            ImPlot::PopStyleVar();
+            // One point per pixel column is all the plot can show, so the engine reduces frames to that
+            if (const auto plotColumns{ static_cast<uint32_t>(size.x) }; plotColumns != engine->GetPlotColumns())
+                engine->SetPlotColumns(plotColumns);
+
+            // The canvas has no background, so the spectrum drawn here stays under the overlay
+            const auto& background{ ImGui::GetStyle().Colors[ImGuiCol_WindowBg] };
+            glClearColor(background.x, background.y, background.z, 1.f);
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            const auto origin{ ImGui::GetWindowPos() };
+
+            // The waterfall takes the lower half, over the same columns
+            const ImVec2 split{ max.x, showWaterfall ? (min.y + max.y) / 2 : max.y };
+            renderer->Draw(origin + min, origin + split, channelColors, !drawOrder, lineWidth, shadeTransparency);
+            waterfall->Upload();
+            if (showWaterfall)
+                waterfall->Draw(origin + ImVec2{ min.x, split.y }, origin + max);
         }
 
 		static uint32_t showConfig{};
@@ -202,33 +128,111 @@ int32_t Application::Run()
 		if (showConfig) {
 			ImGui::Begin("Config");
 			ImGui::SeparatorText("FFT settings");
-			static constexpr const char* fftSizes[] =
-				{ "128", "256", "512", "1024", "2048", "4096", "8192", "16384", "32768" };
-			if (ImGui::BeginCombo("FFT size", std::to_string(fftSize).c_str())) {
-				for (uint32_t i{}; i < IM_ARRAYSIZE(fftSizes); ++i) {
-					if (ImGui::Selectable(fftSizes[i]))
-						ResetFFT(1u << (i + 7));
+			static constexpr const char* precisions[] = { "32-bit float", "64-bit float" };
+			const auto precision{ static_cast<uint32_t>(engine->GetPrecision()) };
+			if (ImGui::BeginCombo("Precision", precisions[precision])) {
+				for (uint32_t i{}; i < IM_ARRAYSIZE(precisions); ++i) {
+					if (ImGui::Selectable(precisions[i], i == precision) && i != precision)
+						SetEnginePrecision(static_cast<SpectrumEngine::Precision>(i));
 				}
 				ImGui::EndCombo();
 			}
+			static constexpr const char* analyzerTypes[] = { "Linear FFT", "Log frequency", "Multi-resolution", "Sliding DFT", "Goertzel bank" };
+			const auto analyzerType{ engine->GetAnalyzerType() };
+			const bool isLog{ analyzerType == SpectrumEngine::AnalyzerType::LOG_FREQUENCY };
+			const bool isSliding{ analyzerType == SpectrumEngine::AnalyzerType::SLIDING_DFT };
+			if (ImGui::BeginCombo("Analyzer", analyzerTypes[static_cast<uint32_t>(analyzerType)])) {
+				for (uint32_t i{}; i < IM_ARRAYSIZE(analyzerTypes); ++i) {
+					const auto type{ static_cast<SpectrumEngine::AnalyzerType>(i) };
+					if (ImGui::Selectable(analyzerTypes[i], type == analyzerType) && type != analyzerType)
+						engine->SetAnalyzer(type, engine->GetBinsPerOctave());
+				}
+				ImGui::EndCombo();
+			}
+			if (isLog || isSliding) {
+				static constexpr uint32_t binsPerOctaveChoices[] = { 12, 24, 48, 96 };
+				if (ImGui::BeginCombo("Bins per octave", std::to_string(engine->GetBinsPerOctave()).c_str())) {
+					for (const uint32_t bins : binsPerOctaveChoices) {
+						if (ImGui::Selectable(std::to_string(bins).c_str(), bins == engine->GetBinsPerOctave()))
+							engine->SetAnalyzer(analyzerType, bins);
+					}
+					ImGui::EndCombo();
+				}
+			}
+			if (!isLog && analyzerType != SpectrumEngine::AnalyzerType::GOERTZEL_BANK) {
+				static constexpr const char* fftSizes[] =
+					{ "128", "256", "512", "1024", "2048", "4096", "8192", "16384", "32768" };
+				// Multi-resolution sizes set the bass band's resolution and start where its top band stays usable
+				const bool isMulti{ analyzerType == SpectrumEngine::AnalyzerType::MULTI_RESOLUTION };
+				if (ImGui::BeginCombo(isMulti ? "Low band size" : "FFT size", std::to_string(engine->GetFFTSize()).c_str())) {
+					for (uint32_t i{ isMulti ? 6u : 0u }; i < IM_ARRAYSIZE(fftSizes); ++i) {
+						if (ImGui::Selectable(fftSizes[i]))
+							engine->Reset(1u << (i + 7));
+					}
+					ImGui::EndCombo();
+				}
+			}
+			const auto windowType{ engine->GetWindowType() };
+			if (ImGui::BeginCombo("Window", GetWindowName(windowType))) {
+				for (uint32_t i{}; i < static_cast<uint32_t>(WindowType::COUNT); ++i) {
+					const auto type{ static_cast<WindowType>(i) };
+					if (ImGui::Selectable(GetWindowName(type), type == windowType) && type != windowType)
+						engine->SetWindow(type);
+				}
+				ImGui::EndCombo();
+			}
+			if (GetDefaultWindowParameter(windowType)) {
+				float windowParameter{ engine->GetWindowParameter() };
+				const bool isKaiser{ windowType == WindowType::KAISER };
+				if (ImGui::SliderFloat(isKaiser ? "Beta" : "Sigma", &windowParameter, 
+									   isKaiser ? 1.f : .1f, isKaiser ? 20.f : .5f, "%.2f"))
+					engine->SetWindow(windowType, windowParameter);
+			}
+			static float overlapPercent{ static_cast<float>(engine->GetOverlap() * 100) };
+			if (ImGui::SliderFloat("Overlap", &overlapPercent, 0.f, 95.f, "%.0f%%"))
+				engine->SetOverlap(overlapPercent / 100);
+			if (analyzerType == SpectrumEngine::AnalyzerType::FFT && channelCount > 1) {
+				static bool stereoPacking{ engine->GetStereoPacking() };
+				if (ImGui::Checkbox("Pack channel pairs into one complex FFT", &stereoPacking))
+					engine->SetStereoPacking(stereoPacking);
+			}
+			static constexpr const char* magnitudeModes[] = { "Exact", "Power", "Fast estimate" };
+			const auto magnitudeMode{ static_cast<uint32_t>(engine->GetMagnitudeMode()) };
+			if (ImGui::BeginCombo("Magnitude", magnitudeModes[magnitudeMode])) {
+				for (uint32_t i{}; i < IM_ARRAYSIZE(magnitudeModes); ++i) {
+					if (ImGui::Selectable(magnitudeModes[i], i == magnitudeMode))
+						engine->SetMagnitudeMode(static_cast<SpectrumEngine::MagnitudeMode>(i));
+				}
+				ImGui::EndCombo();
+			}
+			const auto stats{ engine->GetStats() };
+			ImGui::Text("Frames: %llu analyzed, %llu dropped, %llu coalesced",
+						static_cast<unsigned long long>(stats.analyzed),
+						static_cast<unsigned long long>(stats.dropped),
+						static_cast<unsigned long long>(stats.coalesced));
 
 			ImGui::SeparatorText("Apperances");
 			ImGui::SeparatorText("Window");
             ImGui::Checkbox("Keep title bar", &keepTitleBar);
+            ImGui::Checkbox("Redraw on new frames only", &isEventDriven);
+            ImGui::SliderInt("FPS cap", &fpsCap, 0, 240, fpsCap > 0 ? "%d" : "Off");
 
 			ImGui::SeparatorText("Plotting");
             ImGui::Checkbox("Synchronize channel alpha", &syncChannelAlpha);
 			ImGui::Separator();
 			ImGui::Checkbox("Swap channel draw order", &drawOrder);
+			ImGui::Checkbox("Show waterfall", &showWaterfall);
 
 			ImGui::SliderFloat("Edge size", &lineWidth, 1.f, 10.f);
 			ImGui::SliderFloat("Shade transparency", &shadeTransparency, 0.f, 1.f);
 			static constexpr const char* scaleTypes[] =
 				{ "Linear", "Semi-logarithmic", "Logarithmic" };
-			if (ImGui::BeginCombo("Scale type", std::to_string(scaleType).c_str())) {
+			const auto scaleType{ engine->GetScaleType() };
+			if (ImGui::BeginCombo("Scale type", scaleTypes[static_cast<uint32_t>(scaleType)])) {
 				for (uint32_t i{}; i < IM_ARRAYSIZE(scaleTypes); ++i) {
-					if (ImGui::Selectable(scaleTypes[i]))
-						; // TODO: scale type selection
+					const auto type{ static_cast<SpectrumEngine::ScaleType>(i) };
+					if (ImGui::Selectable(scaleTypes[i], type == scaleType) && type != scaleType)
+						engine->SetScaleType(type);
 				}
 				ImGui::EndCombo();
 			}
@@ -240,16 +244,22 @@ int32_t Application::Run()
 			static float scale{ static_cast<float>(displayScale) };
 			ImGui::SliderFloat("Scale", &scale, .01f, .1f);
 			this->displayScale = scale;
-			static float fallSpeed{ static_cast<float>(fallSpeed) };
-			ImGui::SliderFloat("Fall speed", &fallSpeed, .1f, 1.f);
-			this->fallSpeed = fallSpeed;
+			float fallSpeed{ engine->GetFallSpeed() };
+			if (ImGui::SliderFloat("Fall speed", &fallSpeed, .1f, 1.f))
+				engine->SetFallSpeed(fallSpeed);
 
             ImGui::SeparatorText("Channel draw color");
-			ImGui::PushItemWidth(200);
-			ImGui::ColorPicker3("Color L", &colorL.x);
-			ImGui::SameLine();
-			ImGui::ColorPicker3("Color R", &colorR.x);
-			ImGui::PopItemWidth();
+			if (channelCount == 2) {
+				ImGui::PushItemWidth(200);
+				ImGui::ColorPicker3("Color L", &channelColors[CHANNEL_LEFT].x);
+				ImGui::SameLine();
+				ImGui::ColorPicker3("Color R", &channelColors[CHANNEL_RIGHT].x);
+				ImGui::PopItemWidth();
+			}
+			else {
+				for (uint32_t channel{}; channel < channelCount; ++channel)
+					ImGui::ColorEdit3(("Color " + channelName(channel)).c_str(), &channelColors[channel].x);
+			}
 			ImGui::End();
 		}
 		ImGui::End();
@@ -266,15 +276,29 @@ void Application::InitAudioDevice()
     ma_device_config deviceConfig{};
     deviceConfig = ma_device_config_init(ma_device_type_capture);
     deviceConfig.capture.format   = ma_format_f32;
-    deviceConfig.capture.channels = CHANNEL_COUNT;
-    deviceConfig.sampleRate       = 44100;
+    deviceConfig.capture.channels = 0; // Device's native channel count
+    deviceConfig.sampleRate       = 0; // Device's native rate, so miniaudio does not resample
 	deviceConfig.dataCallback     = AudioDataCallback;
 	deviceConfig.pUserData        = this;
 
 	if (ma_device_init(nullptr, &deviceConfig, &audioDevice) != MA_SUCCESS)
 		throw std::runtime_error{ "Could not initialize audio device\n" };
 
-	std::cout << audioDevice.capture.name << '\n';
+	// Let miniaudio drop whatever the engine cannot take
+	if (audioDevice.capture.channels > MAX_CHANNEL_COUNT) {
+		ma_device_uninit(&audioDevice);
+		deviceConfig.capture.channels = MAX_CHANNEL_COUNT;
+		if (ma_device_init(nullptr, &deviceConfig, &audioDevice) != MA_SUCCESS)
+			throw std::runtime_error{ "Could not initialize audio device\n" };
+	}
+
+	std::cout << audioDevice.capture.name << " (" << audioDevice.capture.channels << " channels, " 
+			  << audioDevice.sampleRate << " Hz)\n";
+
+	SpectrumEngine::Settings settings{};
+	settings.channelCount = audioDevice.capture.channels;
+	settings.sampleRate = audioDevice.sampleRate;
+	engine = SpectrumEngine::Create(settings);
 
 	if (ma_device_start(&audioDevice) != MA_SUCCESS) 
 		throw std::runtime_error{ "Could not start audio device\n" };
@@ -325,38 +349,6 @@ void Application::ImGuiEndFrame()
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 }
 
-void Application::ResetFFT(uint32_t fftSize, WindowType windowType)
-{
-    assert(fftSize >= 128 && fftSize <= 32768);
-    std::scoped_lock lock{ sampleBufferMutex, drawBufferMutex, fftBusyMutex };
-
-	this->fftSize = fftSize;
-
-	fftResultSize = fftSize / 2;
-	sampleBufferSize = fftSize * 2;
-
-	fftInstance = std::make_unique<FFTInstance>(static_cast<int>(fftSize));
-	fftWindow = std::vector<SP_FLOAT>(fftSize);
-	magnitudes = { std::vector<SP_FLOAT>(fftSize), std::vector<SP_FLOAT>(fftSize) };
-	sampleBuffer = { std::vector<SP_FLOAT>(sampleBufferSize), std::vector<SP_FLOAT>(sampleBufferSize) };
-	thresholds = { std::vector<SP_FLOAT>(fftResultSize), std::vector<SP_FLOAT>(fftResultSize) };
-	heights = { std::vector<SP_FLOAT>(fftResultSize), std::vector<SP_FLOAT>(fftResultSize) };
-	xs = { std::vector<SP_FLOAT>(fftResultSize) };
-	ys = { std::vector<SP_FLOAT>(fftResultSize), std::vector<SP_FLOAT>(fftResultSize) };
-
-	for (uint32_t i{}; i < xs.size(); ++i)
-		xs[i] = static_cast<SP_FLOAT>(i);
-
-	switch (windowType) {
-	case WindowType::BLACKMAN_HARRIS:
-		::GenBlackmanHarrisWindow(fftWindow.data(), fftSize);
-		break;
-	default:
-		assert(0 && "Unimplemented");
-		break;
-	}
-}
-
 void Application::CreateWindow(std::initializer_list<WindowHint> hints, bool vsync)
 {
 	for (const auto& [hint, value] : hints)
@@ -376,6 +368,47 @@ void Application::CreateWindow(std::initializer_list<WindowHint> hints, bool vsy
     assert(glVersion);
 }
 
+void Application::SetEnginePrecision(SpectrumEngine::Precision precision)
+{
+	// The capture callback pushes into the engine, so keep it quiet while swapping
+	ma_device_stop(&audioDevice);
+	engine->Stop();
+
+	SpectrumEngine::Settings settings{};
+	settings.precision = precision;
+	settings.channelCount = engine->GetChannelCount();
+	settings.sampleRate = engine->GetSampleRate();
+	settings.fftSize = engine->GetFFTSize();
+	settings.overlap = engine->GetOverlap();
+	settings.stereoPacking = engine->GetStereoPacking();
+	settings.magnitudeMode = engine->GetMagnitudeMode();
+	settings.windowType = engine->GetWindowType();
+	settings.windowParameter = engine->GetWindowParameter();
+	settings.analyzerType = engine->GetAnalyzerType();
+	settings.binsPerOctave = engine->GetBinsPerOctave();
+	settings.targetFrequencies = engine->GetTargetFrequencies();
+	settings.plotColumns = engine->GetPlotColumns();
+	settings.scaleType = engine->GetScaleType();
+	settings.fallSpeed = engine->GetFallSpeed();
+	engine = SpectrumEngine::Create(settings);
+
+	engine->SetPlotCallback([this](const auto& frame) { OnPlot(frame); });
+	engine->Start();
+	if (ma_device_start(&audioDevice) != MA_SUCCESS)
+		throw std::runtime_error{ "Could not start audio device\n" };
+}
+
+// Runs on the analysis thread
+void Application::OnPlot(const SpectrumEngine::Frame& frame)
+{
+	renderer->Write(frame.positions, frame.heights);
+	waterfall->Write(frame.levels);
+
+	// One wake-up per redraw is enough, however many frames arrive before it
+	if (!isFramePending.exchange(true))
+		glfwPostEmptyEvent();
+}
+
 SP_APP_ENTRY()
 
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Config.h"
+#include "SpectrumEngine.h"
 
 #include <cstdint>
 #include <memory>
@@ -16,13 +17,12 @@
 #include <miniaudio.h>
 
 struct GLFWwindow;
+class SpectrumRenderer;
+class WaterfallRenderer;
 
 class Application
 {
 public:
-    enum class WindowType {
-        BLACKMAN_HARRIS
-    };
     using WindowHint = std::pair<int32_t, int32_t>;
 
 public:
@@ -38,45 +38,28 @@ public:
     void ImGuiBeginFrame();
     void ImGuiEndFrame();
 
-    void ResetFFT(uint32_t fftSize, WindowType windowType = WindowType::BLACKMAN_HARRIS);
     void CreateWindow(std::initializer_list<WindowHint> hints, bool vsync = true);
 
+    void SetEnginePrecision(SpectrumEngine::Precision precision);
+
 private: 
     static void AudioDataCallback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount);
-    static void FFTWorker(Application* app);
+    void OnPlot(const SpectrumEngine::Frame& frame);
 
 private:
-    uint32_t fftSize{};
-    uint32_t fftResultSize{};
-    uint32_t sampleBufferSize{}; 
-
-    uint32_t readPtr{};
-    uint32_t writePtr{};
-
-    std::unique_ptr<FFTInstance>                     fftInstance{};
-    std::vector<SP_FLOAT>                            fftWindow{};
-    std::array<std::vector<SP_FLOAT>, CHANNEL_COUNT> magnitudes{};
-    std::array<std::vector<SP_FLOAT>, CHANNEL_COUNT> sampleBuffer{};
-    std::array<std::vector<SP_FLOAT>, CHANNEL_COUNT> thresholds{};
-    std::array<std::vector<SP_FLOAT>, CHANNEL_COUNT> heights{};
-    std::vector<SP_FLOAT>                            xs{};
-    std::array<std::vector<SP_FLOAT>, CHANNEL_COUNT> ys{};
+    std::unique_ptr<SpectrumEngine>    engine{};
+    std::unique_ptr<SpectrumRenderer>  renderer{};
+    std::unique_ptr<WaterfallRenderer> waterfall{};
 
-	SP_FLOAT displayOffset{};
-	SP_FLOAT displayScale{ 1.0 };
-	SP_FLOAT fallSpeed{ 0.1 };
+	float displayOffset{};
+	float displayScale{ 1.f };
 
-	std::mutex sampleBufferMutex{};
-	std::mutex drawBufferMutex{};
-	std::mutex fftBusyMutex{};
-
-	std::mutex sampleAvailMutex{};
-	std::condition_variable sampleAvailCond{};
+    // Frame pacing: redraw only on input or a published frame, and at most fpsCap times a second
+    bool             isEventDriven{ true };
+    int32_t          fpsCap{};
+    std::atomic_bool isFramePending{};
 
     GLFWwindow* window{};
 
     ma_device   audioDevice{};
-
-    std::thread fftThread{};
-    std::atomic_bool isRunning{ true };
 };
@@ -1,6 +1,10 @@
 #pragma once
 
-#ifdef SP_USE_F64
+// The engine is instantiated in both precisions
+#ifndef PFFFT_ENABLE_FLOAT
+#define PFFFT_ENABLE_FLOAT
+#endif
+#ifndef PFFFT_ENABLE_DOUBLE
 #define PFFFT_ENABLE_DOUBLE
 #endif
 #include <pffft.hpp>
@@ -13,31 +17,15 @@
 #undef CreateWindow
 #endif
 
-#define SP_ARRAY_SIZE(x) (sizeof(x)/sizeof(x[0]))
-
-#ifdef SP_USE_F64
-#define SP_FLOAT double
-#else 
-#define SP_FLOAT float
+#if defined(__AVX2__)
+#define SP_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SP_SIMD_SSE2
 #endif
 
-#ifdef SP_USE_F64
-#define SP_LOG2(x) std::log2(x)
-#define SP_LOG(x) std::log(x)
-#define SP_ABS(x) std::fabs(x)
-#define SP_EXP(x) std::exp(x)
-#define SP_POW(x,y) std::pow(x,y)
-#define SP_SIN(x) std::sin(x)
-#define SP_COS(x) std::cos(x)
-#else
-#define SP_LOG2(x) std::log2f(x)
-#define SP_LOG(x) std::logf(x)
-#define SP_ABS(x) std::fabsf(x)
-#define SP_EXP(x) std::expf(x)
-#define SP_POW(x,y) std::powf(x,y)
-#define SP_SIN(x) std::sinf(x)
-#define SP_COS(x) std::cosf(x)
-#endif
+#define SP_ARRAY_SIZE(x) (sizeof(x)/sizeof(x[0]))
+#define SP_STRINGIFY_1(x) #x
+#define SP_STRINGIFY(x) SP_STRINGIFY_1(x)
 
 #define SP_TIME_NOW() std::chrono::high_resolution_clock::now()
 #define SP_TIMEPOINT decltype(SP_TIME_NOW())
@@ -50,16 +38,39 @@
             HINSTANCE hPrevInstance, \
             PSTR lpCmdLine, \
             int nCmdShow) \
-{ return std::make_unique<Application>()->Run(); }
+{ \
+    if (IsOfflineAnalysis(__argc, __argv)) \
+        return RunOfflineAnalysis(__argc, __argv); \
+    return std::make_unique<Application>()->Run(); \
+}
 #else 
 #error "Unsupported platform"
 #endif
 #else 
-#define SP_APP_ENTRY() int main(int argc, char** argv) { return std::make_unique<Application>()->Run(); }
+#define SP_APP_ENTRY() int main(int argc, char** argv) \
+{ \
+    if (IsOfflineAnalysis(argc, argv)) \
+        return RunOfflineAnalysis(argc, argv); \
+    return std::make_unique<Application>()->Run(); \
+}
 #endif
 
-enum Channel : uint32_t { CHANNEL_LEFT, CHANNEL_RIGHT, CHANNEL_COUNT };
+enum Channel : uint32_t { CHANNEL_LEFT, CHANNEL_RIGHT };
+
+static constexpr uint32_t DEFAULT_CHANNEL_COUNT{ 2 };
+static constexpr uint32_t MAX_CHANNEL_COUNT{ 32 };
+static constexpr uint32_t DEFAULT_SAMPLE_RATE{ 48000 };
 
-using FFTInstance = pffft::Fft<SP_FLOAT>;
+template <typename T> using FFTInstance = pffft::Fft<T>;
+template <typename T> using FFTValueVector = pffft::AlignedVector<T>;
+template <typename T> using FFTSpectrumVector = pffft::AlignedVector<std::complex<T>>;
+template <typename T> using ComplexFFTInstance = pffft::Fft<std::complex<T>>;
 
 static constexpr uint32_t MAX_FFT_SIZE{ 32768 };
+static constexpr uint32_t SAMPLE_RING_SIZE{ MAX_FFT_SIZE * 2 };
+static constexpr uint32_t MAX_CATCHUP_FRAMES{ 8 };
+static constexpr uint32_t DEFAULT_BINS_PER_OCTAVE{ 24 };
+static constexpr float    FALL_RATE{ 20.f };  // Peak fall in 1/s at a fall speed of 1
+static constexpr float    PLOT_MIN_HEIGHT{ .001f };
+static constexpr float    PLOT_MAX_HEIGHT{ 100.f };
+static constexpr double   IDLE_REDRAW_INTERVAL{ .5 };  // Seconds an event-driven loop waits without a frame
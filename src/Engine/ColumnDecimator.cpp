@@ -0,0 +1,80 @@
+#include "ColumnDecimator.h"
+
+#include <algorithm>
+#include <cassert>
+
+template <typename T>
+ColumnDecimator<T>::ColumnDecimator(const std::vector<float>& binPositions, uint32_t columnCount)
+{
+    assert(columnCount);
+    const auto columnPosition = [columnCount](float column) { return column / columnCount; };
+
+    // The bins on the axis
+    const auto begin{ static_cast<uint32_t>(std::lower_bound(binPositions.begin(), binPositions.end(), 0.f) -
+                                            binPositions.begin()) };
+    const auto end{ static_cast<uint32_t>(std::upper_bound(binPositions.begin(), binPositions.end(), 1.f) -
+                                          binPositions.begin()) };
+    if (begin >= end)
+        return;
+
+    uint32_t bin{ begin };
+    for (uint32_t column{}; column < columnCount; ++column) {
+        // The last column closes the range, so the axis' end itself still lands in it
+        const float edge{ columnPosition(column + 1.f) };
+        uint32_t last{ bin };
+        while (last < end && (binPositions[last] < edge || column + 1 == columnCount))
+            ++last;
+
+        if (last - bin == 1) {
+            positions.push_back(binPositions[bin]);
+        }
+        else if (last > bin) {
+            positions.push_back(columnPosition(column + .5f));
+            positions.push_back(positions.back());
+        }
+
+        if (last > bin) {
+            columns.push_back({ bin, last });
+            levelColumns.push_back({ bin, last });
+        }
+        else {
+            // Nearest along the axis, so by frequency ratio on a log one
+            const float centre{ columnPosition(column + .5f) };
+            uint32_t nearest{ std::min(bin, end - 1) };
+            if (nearest > begin && 2 * centre < binPositions[nearest - 1] + binPositions[nearest])
+                --nearest;
+            levelColumns.push_back({ nearest, nearest + 1 });
+        }
+        bin = last;
+    }
+}
+
+template <typename T>
+void ColumnDecimator<T>::Decimate(const T* heights, float* dst) const
+{
+    for (const auto& [first, last] : columns) {
+        if (last - first == 1) {
+            *dst++ = static_cast<float>(heights[first]);
+            continue;
+        }
+        const auto [low, high] { std::minmax_element(heights + first, heights + last) };
+        const bool isLowFirst{ low < high };
+        *dst++ = static_cast<float>(isLowFirst ? *low : *high);
+        *dst++ = static_cast<float>(isLowFirst ? *high : *low);
+    }
+}
+
+template <typename T>
+void ColumnDecimator<T>::Quantize(const T* const* heights, uint32_t channelCount, const PlotScale& scale, uint8_t* dst) const
+{
+    for (const auto& [first, last] : levelColumns) {
+        T peak{};
+        for (uint32_t channel{}; channel < channelCount; ++channel)
+            peak = std::max(peak, *std::max_element(heights[channel] + first, heights[channel] + last));
+
+        *dst++ = static_cast<uint8_t>(scale.MapHeight(static_cast<float>(peak)) * 255);
+    }
+}
+
+template class ColumnDecimator<float>;
+template class ColumnDecimator<double>;
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "PlotScale.h"
+
+#include <cstdint>
+#include <vector>
+
+// Reduces a spectrum to the pixel columns of the plot: a column holding several bins
+// becomes their minimum and maximum in the order they occur, so narrow peaks survive,
+// a column holding one bin passes it through at its own position and
+// an empty one produces nothing. The bin range of every column is worked out once per
+// layout, so a frame is a single pass over the bins.
+template <typename T>
+class ColumnDecimator
+{
+public:
+    // `binPositions` ascending, see PlotScale::MapFrequencies(); bins outside 0..1 are left out
+    ColumnDecimator(const std::vector<float>& binPositions, uint32_t columnCount);
+
+    // Where the decimated points go, two per column that holds several bins
+    const std::vector<float>& GetPositions() const { return positions; }
+    uint32_t GetSize() const { return static_cast<uint32_t>(positions.size()); }
+    uint32_t GetColumnCount() const { return static_cast<uint32_t>(levelColumns.size()); }
+
+    void Decimate(const T* heights, float* dst) const;
+
+    // One colormap index per column for the loudest of `channelCount` spectra, spreading
+    // the height axis of `scale` over 0..255. Columns without a bin of their own take
+    // the nearest one, so every column gets a value.
+    void Quantize(const T* const* heights, uint32_t channelCount, const PlotScale& scale, uint8_t* dst) const;
+
+private:
+    struct Column {
+        uint32_t first{};
+        uint32_t last{};  // One past the column's last bin
+    };
+
+    std::vector<Column> columns{};
+    std::vector<float>  positions{};
+    std::vector<Column> levelColumns{};  // One per column, none of them empty
+};
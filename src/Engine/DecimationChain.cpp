@@ -0,0 +1,157 @@
+#include "DecimationChain.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+// Half-band taps: 0.5 sinc(n / 2) with a Blackman window. Passes [0, 0.2) and stops
+// [0.3, 0.5] of the input rate.
+static constexpr uint32_t HALF_BAND_TAPS{ 55 };
+static constexpr uint32_t HALF_BAND_CENTER{ HALF_BAND_TAPS / 2 };
+
+// Every even tap but the center one is zero, so only the odd ones are kept
+struct HalfBandTaps {
+    double                                      center{};
+    std::array<double, HALF_BAND_CENTER / 2 + 1> odd{};
+};
+
+const HalfBandTaps& GetHalfBandTaps()
+{
+    static const HalfBandTaps taps{ [] {
+        static constexpr double PI{ 3.14159265358979323846 };
+        HalfBandTaps t{};
+        t.center = 0.5;
+        double sum{ t.center };
+        for (uint32_t j{}; j < t.odd.size(); ++j) {
+            const double n{ 2.0 * j + 1 };
+            const double x{ 2 * PI * (HALF_BAND_CENTER + n) / (HALF_BAND_TAPS - 1) };
+            const double blackman{ 0.42 - 0.5 * std::cos(x) + 0.08 * std::cos(2 * x) };
+            t.odd[j] = std::sin(PI * n / 2) / (PI * n) * blackman;
+            sum += 2 * t.odd[j];
+        }
+        // Unity gain at DC
+        t.center /= sum;
+        for (auto& tap : t.odd)
+            tap /= sum;
+        return t;
+    }() };
+    return taps;
+}
+
+}
+
+template <typename T>
+class DecimationChain<T>::HalfBandDecimator
+{
+public:
+    HalfBandDecimator() : delay(2 * HALF_BAND_TAPS)
+    {
+        const auto& taps{ GetHalfBandTaps() };
+        centerTap = static_cast<T>(taps.center);
+        for (uint32_t j{}; j < oddTaps.size(); ++j)
+            oddTaps[j] = static_cast<T>(taps.odd[j]);
+    }
+
+    void Reset()
+    {
+        std::fill(delay.begin(), delay.end(), T{});
+        position = 0;
+        phase = 0;
+    }
+
+    // Returns the number of samples written to `out`, count / 2 rounded either way
+    uint32_t Process(const T* in, uint32_t count, T* out)
+    {
+        uint32_t produced{};
+        for (uint32_t i{}; i < count; ++i) {
+            delay[position] = delay[position + HALF_BAND_TAPS] = in[i];
+            position = position + 1 == HALF_BAND_TAPS ? 0 : position + 1;
+            if ((phase ^= 1u))
+                continue;
+
+            // The newest HALF_BAND_TAPS samples, oldest first
+            const T* x{ delay.data() + position + HALF_BAND_CENTER };
+            T y{ centerTap * x[0] };
+            for (uint32_t j{}; j < oddTaps.size(); ++j)
+                y += oddTaps[j] * (x[-static_cast<int32_t>(2 * j + 1)] + x[2 * j + 1]);
+            out[produced++] = y;
+        }
+        return produced;
+    }
+
+private:
+    std::array<T, HALF_BAND_CENTER / 2 + 1> oddTaps{};
+    T              centerTap{};
+    std::vector<T> delay{};
+    uint32_t       position{};
+    uint32_t       phase{};
+};
+
+template <typename T>
+DecimationChain<T>::DecimationChain(const std::vector<uint32_t>& historySizes) :
+    levels(historySizes.size())
+{
+    assert(!levels.empty());
+    for (size_t i{}; i < levels.size(); ++i) {
+        assert((historySizes[i] & (historySizes[i] - 1)) == 0);
+        levels[i].size = historySizes[i];
+        levels[i].history = std::vector<T>(2 * historySizes[i]);
+    }
+    for (size_t i{ 1 }; i < levels.size(); ++i)
+        decimators.push_back(std::make_unique<HalfBandDecimator>());
+}
+
+template <typename T>
+DecimationChain<T>::~DecimationChain() = default;
+
+template <typename T>
+void DecimationChain<T>::Reset()
+{
+    for (auto& level : levels) {
+        std::fill(level.history.begin(), level.history.end(), T{});
+        level.position = 0;
+        level.written = 0;
+    }
+    for (auto& decimator : decimators)
+        decimator->Reset();
+}
+
+template <typename T>
+void DecimationChain<T>::Push(const T* samples, uint32_t count)
+{
+    Write(levels[0], samples, count);
+
+    const T* in{ samples };
+    for (uint32_t level{ 1 }; level < levels.size() && count; ++level) {
+        auto& out{ scratch[level & 1] };
+        if (out.size() < count / 2 + 1)
+            out.resize(count / 2 + 1);
+        count = decimators[level - 1]->Process(in, count, out.data());
+        Write(levels[level], out.data(), count);
+        in = out.data();
+    }
+}
+
+template <typename T>
+void DecimationChain<T>::Write(Level& level, const T* samples, uint32_t count)
+{
+    level.written += count;
+    if (!level.size)
+        return;
+
+    // Only the newest `size` samples survive anyway
+    if (count > level.size) {
+        samples += count - level.size;
+        count = level.size;
+    }
+    for (uint32_t i{}; i < count; ++i) {
+        level.history[level.position] = level.history[level.position + level.size] = samples[i];
+        level.position = (level.position + 1) & (level.size - 1);
+    }
+}
+
+template class DecimationChain<float>;
+template class DecimationChain<double>;
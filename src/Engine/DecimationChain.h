@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Cascaded half-band decimators with a history buffer per level. Level k runs at
+// 1 / 2^k of the input rate and is free of aliases over [0, 0.4) of its own rate;
+// [0.4, 0.5) holds the folded transition band of the last stage.
+template <typename T>
+class DecimationChain
+{
+public:
+    // One history length per level, each a power of two, or 0 for a level that is
+    // only passed through to the ones below it.
+    explicit DecimationChain(const std::vector<uint32_t>& historySizes);
+    ~DecimationChain();
+
+    uint32_t GetLevelCount() const { return static_cast<uint32_t>(levels.size()); }
+
+    void Reset();
+
+    // Feeds consecutive input samples through every level.
+    void Push(const T* samples, uint32_t count);
+
+    // The newest samples of a level, oldest first.
+    const T* GetHistory(uint32_t level) const { return levels[level].history.data() + levels[level].position; }
+
+    // Samples a level has received since the last Reset().
+    uint64_t GetWritten(uint32_t level) const { return levels[level].written; }
+
+private:
+    class HalfBandDecimator;
+
+    struct Level {
+        std::vector<T> history{};  // Written twice so it reads contiguously
+        uint32_t       size{};
+        uint32_t       position{};
+        uint64_t       written{};
+    };
+
+    void Write(Level& level, const T* samples, uint32_t count);
+
+private:
+    std::vector<Level>                               levels{};
+    std::vector<std::unique_ptr<HalfBandDecimator>>  decimators{};
+    std::vector<T>                                   scratch[2]{};
+};
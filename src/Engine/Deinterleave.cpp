@@ -0,0 +1,92 @@
+#include "Deinterleave.h"
+
+#if defined(SP_SIMD_AVX2) || defined(SP_SIMD_SSE2)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+template <typename T>
+void DeinterleaveScalar(const float* src, uint32_t channelCount, T* const* dst, uint32_t begin, uint32_t end)
+{
+    for (uint32_t i{ begin }; i < end; ++i) {
+        for (uint32_t channel{}; channel < channelCount; ++channel)
+            dst[channel][i] = static_cast<T>(src[i * channelCount + channel]);
+    }
+}
+
+#if defined(SP_SIMD_AVX2)
+static constexpr uint32_t STEREO_BLOCK{ 8 };
+
+inline void StoreBlock(float* dst, __m256 v) { _mm256_storeu_ps(dst, v); }
+inline void StoreBlock(double* dst, __m256 v)
+{
+    _mm256_storeu_pd(dst, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+    _mm256_storeu_pd(dst + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+}
+
+template <typename T>
+uint32_t DeinterleaveStereoSimd(const float* src, T* left, T* right, uint32_t frameCount)
+{
+    uint32_t i{};
+    for (; i + STEREO_BLOCK <= frameCount; i += STEREO_BLOCK) {
+        const __m256 a{ _mm256_loadu_ps(src + 2 * i) };
+        const __m256 b{ _mm256_loadu_ps(src + 2 * i + 8) };
+        // In-lane shuffle leaves 64-bit pairs as [0 2 1 3]; permute restores order
+        const __m256 l{ _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)) };
+        const __m256 r{ _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)) };
+        StoreBlock(left + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(l), _MM_SHUFFLE(3, 1, 2, 0))));
+        StoreBlock(right + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(r), _MM_SHUFFLE(3, 1, 2, 0))));
+    }
+    return i;
+}
+#elif defined(SP_SIMD_SSE2)
+static constexpr uint32_t STEREO_BLOCK{ 4 };
+
+inline void StoreBlock(float* dst, __m128 v) { _mm_storeu_ps(dst, v); }
+inline void StoreBlock(double* dst, __m128 v)
+{
+    _mm_storeu_pd(dst, _mm_cvtps_pd(v));
+    _mm_storeu_pd(dst + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+}
+
+template <typename T>
+uint32_t DeinterleaveStereoSimd(const float* src, T* left, T* right, uint32_t frameCount)
+{
+    uint32_t i{};
+    for (; i + STEREO_BLOCK <= frameCount; i += STEREO_BLOCK) {
+        const __m128 a{ _mm_loadu_ps(src + 2 * i) };
+        const __m128 b{ _mm_loadu_ps(src + 2 * i + 4) };
+        StoreBlock(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        StoreBlock(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+    return i;
+}
+#else
+template <typename T>
+uint32_t DeinterleaveStereoSimd(const float*, T*, T*, uint32_t)
+{
+    return 0;
+}
+#endif
+
+template <typename T>
+void DeinterleaveImpl(const float* src, uint32_t channelCount, T* const* dst, uint32_t frameCount)
+{
+    uint32_t done{};
+    if (channelCount == 2)
+        done = DeinterleaveStereoSimd(src, dst[0], dst[1], frameCount);
+    DeinterleaveScalar(src, channelCount, dst, done, frameCount);
+}
+
+}
+
+void Deinterleave(const float* src, uint32_t channelCount, float* const* dst, uint32_t frameCount)
+{
+    DeinterleaveImpl(src, channelCount, dst, frameCount);
+}
+
+void Deinterleave(const float* src, uint32_t channelCount, double* const* dst, uint32_t frameCount)
+{
+    DeinterleaveImpl(src, channelCount, dst, frameCount);
+}
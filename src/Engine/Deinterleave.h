@@ -0,0 +1,8 @@
+#pragma once
+
+#include "Config.h"
+
+// Splits `frameCount` interleaved f32 frames of `channelCount` channels into the planar
+// buffers `dst[0..channelCount)`. Stereo input takes the SIMD path.
+void Deinterleave(const float* src, uint32_t channelCount, float* const* dst, uint32_t frameCount);
+void Deinterleave(const float* src, uint32_t channelCount, double* const* dst, uint32_t frameCount);
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cassert>
+#include <algorithm>
+#include <utility>
+
+// Deferred deletion for objects published through an atomic pointer. A reader pins
+// the current epoch before loading the pointer and unpins when done; the writer
+// retires the object it swapped out, and Collect() frees it once every pinned
+// reader has moved past the epoch it was retired in. Readers never block or wait.
+//
+// Each reader slot must be used by one thread at a time; Retire()/Collect() by one writer.
+template <typename T, uint32_t MaxReaders = 1>
+class EpochReclaimer
+{
+public:
+    class Guard
+    {
+    public:
+        explicit Guard(std::atomic<uint64_t>& slot) : slot{ &slot } {}
+        Guard(Guard&& other) noexcept : slot{ std::exchange(other.slot, nullptr) } {}
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        ~Guard()
+        {
+            if (slot)
+                slot->store(0, std::memory_order_release);
+        }
+
+    private:
+        std::atomic<uint64_t>* slot{};
+    };
+
+public:
+    EpochReclaimer() = default;
+    EpochReclaimer(const EpochReclaimer&) = delete;
+    EpochReclaimer& operator=(const EpochReclaimer&) = delete;
+
+    // Everything loaded through the published pointer while the guard lives stays valid.
+    [[nodiscard]] Guard Pin(uint32_t reader)
+    {
+        assert(reader < MaxReaders);
+        // seq_cst so the pointer load that follows cannot move above the pin
+        readerEpochs[reader].store(globalEpoch.load());
+        return Guard{ readerEpochs[reader] };
+    }
+
+    // Call after the object was swapped out of the published pointer.
+    void Retire(std::unique_ptr<T> object)
+    {
+        retired.push_back({ globalEpoch.fetch_add(1), std::move(object) });
+    }
+
+    void Collect()
+    {
+        uint64_t oldestPinned{ UINT64_MAX };
+        for (const auto& epoch : readerEpochs) {
+            if (const uint64_t e{ epoch.load() })
+                oldestPinned = std::min(oldestPinned, e);
+        }
+        retired.erase(std::remove_if(retired.begin(), retired.end(), [&](const Retired& r) {
+            return r.epoch < oldestPinned;
+        }), retired.end());
+    }
+
+    bool HasRetired() const { return !retired.empty(); }
+
+private:
+    struct Retired {
+        uint64_t           epoch{};
+        std::unique_ptr<T> object{};
+    };
+
+private:
+    // Starts at 1 so that 0 can mark an idle reader
+    std::atomic<uint64_t> globalEpoch{ 1 };
+    std::atomic<uint64_t> readerEpochs[MaxReaders]{};
+    std::vector<Retired>  retired{};
+};
@@ -0,0 +1,175 @@
+#include "FFTWindow.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+namespace {
+
+static constexpr double PI{ 3.14159265358979323846 };
+
+// Entries only the cache still holds are evicted once it grows past this,
+// which keeps continuous parameters (Kaiser beta, Gaussian sigma) from piling up
+static constexpr size_t MAX_CACHED_WINDOWS{ 64 };
+
+// Periodic (DFT-even) cosine-sum window: sum_k (-1)^k a_k cos(2 pi k n / N)
+template <typename T, size_t K>
+void GenCosineSumWindow(const double (&a)[K], T* dst, uint32_t size)
+{
+    const double N{ static_cast<double>(size) };
+    for (uint32_t i{}; i < size; ++i) {
+        double value{};
+        for (size_t k{}; k < K; ++k)
+            value += (k & 1 ? -a[k] : a[k]) * std::cos(2 * PI * k * i / N);
+        dst[i] = static_cast<T>(value);
+    }
+}
+
+// Zeroth-order modified Bessel function of the first kind, by its power series
+double BesselI0(double x)
+{
+    double sum{ 1 };
+    double term{ 1 };
+    for (uint32_t k{ 1 }; term > sum * 1e-17; ++k) {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+template <typename T>
+void GenKaiserWindow(T* dst, uint32_t size, double beta)
+{
+    const double half{ size / 2.0 };
+    const double norm{ BesselI0(beta) };
+    for (uint32_t i{}; i < size; ++i) {
+        const double x{ (i - half) / half };
+        dst[i] = static_cast<T>(BesselI0(beta * std::sqrt(std::max(0.0, 1 - x * x))) / norm);
+    }
+}
+
+template <typename T>
+void GenGaussianWindow(T* dst, uint32_t size, double sigma)
+{
+    const double half{ size / 2.0 };
+    for (uint32_t i{}; i < size; ++i) {
+        const double x{ (i - half) / (sigma * half) };
+        dst[i] = static_cast<T>(std::exp(-0.5 * x * x));
+    }
+}
+
+struct WindowKey {
+    WindowType type{};
+    uint32_t   size{};
+    float      parameter{};
+
+    bool operator<(const WindowKey& other) const
+    {
+        return std::tie(type, size, parameter) < std::tie(other.type, other.size, other.parameter);
+    }
+};
+
+template <typename T>
+struct WindowCache {
+    std::mutex mutex{};
+    std::map<WindowKey, std::shared_ptr<const FFTValueVector<T>>> tables{};
+};
+
+template <typename T>
+WindowCache<T>& GetWindowCache()
+{
+    static WindowCache<T> cache{};
+    return cache;
+}
+
+}
+
+const char* GetWindowName(WindowType type)
+{
+    static constexpr const char* names[] = 
+        { "Blackman-Harris", "Hann", "Hamming", "Nuttall", "Flat top", "Kaiser", "Gaussian" };
+    static_assert(SP_ARRAY_SIZE(names) == static_cast<size_t>(WindowType::COUNT));
+    return names[static_cast<size_t>(type)];
+}
+
+float GetDefaultWindowParameter(WindowType type)
+{
+    switch (type) {
+    case WindowType::KAISER:
+        return 8.6f;
+    case WindowType::GAUSSIAN:
+        return 0.4f;
+    default:
+        return 0;
+    }
+}
+
+template <typename T>
+void GenWindow(WindowType type, T* dst, uint32_t size, float parameter)
+{
+    if (!parameter)
+        parameter = GetDefaultWindowParameter(type);
+
+    switch (type) {
+    case WindowType::BLACKMAN_HARRIS:
+        GenCosineSumWindow({ 0.35875, 0.48829, 0.14128, 0.01168 }, dst, size);
+        break;
+    case WindowType::HANN:
+        GenCosineSumWindow({ 0.5, 0.5 }, dst, size);
+        break;
+    case WindowType::HAMMING:
+        GenCosineSumWindow({ 0.54, 0.46 }, dst, size);
+        break;
+    case WindowType::NUTTALL:
+        GenCosineSumWindow({ 0.355768, 0.487396, 0.144232, 0.012604 }, dst, size);
+        break;
+    case WindowType::FLAT_TOP:
+        GenCosineSumWindow({ 0.21557895, 0.41663158, 0.277263158, 0.083578947, 0.006947368 }, dst, size);
+        break;
+    case WindowType::KAISER:
+        GenKaiserWindow(dst, size, parameter);
+        break;
+    case WindowType::GAUSSIAN:
+        GenGaussianWindow(dst, size, parameter);
+        break;
+    default:
+        assert(0 && "Unimplemented");
+        break;
+    }
+}
+
+template <typename T>
+std::shared_ptr<const FFTValueVector<T>> GetWindow(WindowType type, uint32_t size, float parameter)
+{
+    // Parameterless windows share one entry whatever was passed
+    const float defaultParameter{ GetDefaultWindowParameter(type) };
+    if (!defaultParameter)
+        parameter = 0;
+    else if (!parameter)
+        parameter = defaultParameter;
+    const WindowKey key{ type, size, parameter };
+
+    auto& cache{ GetWindowCache<T>() };
+    std::lock_guard lock{ cache.mutex };
+    if (const auto it{ cache.tables.find(key) }; it != cache.tables.end())
+        return it->second;
+
+    if (cache.tables.size() >= MAX_CACHED_WINDOWS) {
+        for (auto it{ cache.tables.begin() }; it != cache.tables.end();)
+            it = it->second.use_count() == 1 ? cache.tables.erase(it) : std::next(it);
+    }
+
+    auto table{ std::make_shared<FFTValueVector<T>>(size) };
+    GenWindow(type, table->data(), size, parameter);
+    cache.tables.emplace(key, table);
+    return table;
+}
+
+template void GenWindow<float>(WindowType type, float* dst, uint32_t size, float parameter);
+template void GenWindow<double>(WindowType type, double* dst, uint32_t size, float parameter);
+template std::shared_ptr<const FFTValueVector<float>> GetWindow<float>(WindowType type, uint32_t size, float parameter);
+template std::shared_ptr<const FFTValueVector<double>> GetWindow<double>(WindowType type, uint32_t size, float parameter);
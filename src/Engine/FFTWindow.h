@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Config.h"
+
+#include <memory>
+
+enum class WindowType {
+    BLACKMAN_HARRIS,
+    HANN,
+    HAMMING,
+    NUTTALL,
+    FLAT_TOP,
+    KAISER,     // Parameter is beta
+    GAUSSIAN,   // Parameter is sigma, relative to half the window length
+    COUNT
+};
+
+const char* GetWindowName(WindowType type);
+
+// Kaiser beta / Gaussian sigma used when a parameter of 0 is given; 0 for windows without one
+float GetDefaultWindowParameter(WindowType type);
+
+template <typename T>
+void GenWindow(WindowType type, T* dst, uint32_t size, float parameter = 0);
+
+// Tables are built once per (type, size, precision, parameter) and shared by every
+// engine, so switching back to a window that was used before costs a map lookup.
+template <typename T>
+std::shared_ptr<const FFTValueVector<T>> GetWindow(WindowType type, uint32_t size, float parameter = 0);
@@ -0,0 +1,192 @@
+#include "GoertzelBank.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#if defined(SP_SIMD_AVX2) || defined(SP_SIMD_SSE2)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+static constexpr double PI{ 3.14159265358979323846 };
+
+// Vectors of targets filtered per pass; each is a dependency chain through every
+// sample, so several run interleaved
+static constexpr uint32_t LANES{ 4 };
+
+template <typename T>
+struct ScalarOps {
+    using Vector = T;
+    static constexpr uint32_t WIDTH{ 1 };
+    static Vector Load(const T* src) { return *src; }
+    static void Store(T* dst, Vector v) { *dst = v; }
+    static Vector Set(T x) { return x; }
+    static Vector Add(Vector a, Vector b) { return a + b; }
+    static Vector Sub(Vector a, Vector b) { return a - b; }
+    static Vector Mul(Vector a, Vector b) { return a * b; }
+};
+
+#if defined(SP_SIMD_AVX2)
+struct FloatOps {
+    using Vector = __m256;
+    static constexpr uint32_t WIDTH{ 8 };
+    static Vector Load(const float* src) { return _mm256_loadu_ps(src); }
+    static void Store(float* dst, Vector v) { _mm256_storeu_ps(dst, v); }
+    static Vector Set(float x) { return _mm256_set1_ps(x); }
+    static Vector Add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+    static Vector Sub(Vector a, Vector b) { return _mm256_sub_ps(a, b); }
+    static Vector Mul(Vector a, Vector b) { return _mm256_mul_ps(a, b); }
+};
+
+struct DoubleOps {
+    using Vector = __m256d;
+    static constexpr uint32_t WIDTH{ 4 };
+    static Vector Load(const double* src) { return _mm256_loadu_pd(src); }
+    static void Store(double* dst, Vector v) { _mm256_storeu_pd(dst, v); }
+    static Vector Set(double x) { return _mm256_set1_pd(x); }
+    static Vector Add(Vector a, Vector b) { return _mm256_add_pd(a, b); }
+    static Vector Sub(Vector a, Vector b) { return _mm256_sub_pd(a, b); }
+    static Vector Mul(Vector a, Vector b) { return _mm256_mul_pd(a, b); }
+};
+#elif defined(SP_SIMD_SSE2)
+struct FloatOps {
+    using Vector = __m128;
+    static constexpr uint32_t WIDTH{ 4 };
+    static Vector Load(const float* src) { return _mm_loadu_ps(src); }
+    static void Store(float* dst, Vector v) { _mm_storeu_ps(dst, v); }
+    static Vector Set(float x) { return _mm_set1_ps(x); }
+    static Vector Add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+    static Vector Sub(Vector a, Vector b) { return _mm_sub_ps(a, b); }
+    static Vector Mul(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+};
+
+struct DoubleOps {
+    using Vector = __m128d;
+    static constexpr uint32_t WIDTH{ 2 };
+    static Vector Load(const double* src) { return _mm_loadu_pd(src); }
+    static void Store(double* dst, Vector v) { _mm_storeu_pd(dst, v); }
+    static Vector Set(double x) { return _mm_set1_pd(x); }
+    static Vector Add(Vector a, Vector b) { return _mm_add_pd(a, b); }
+    static Vector Sub(Vector a, Vector b) { return _mm_sub_pd(a, b); }
+    static Vector Mul(Vector a, Vector b) { return _mm_mul_pd(a, b); }
+};
+#endif
+
+#if defined(SP_SIMD_AVX2) || defined(SP_SIMD_SSE2)
+template <typename T> struct SimdOps;
+template <> struct SimdOps<float> : FloatOps {};
+template <> struct SimdOps<double> : DoubleOps {};
+#else
+template <typename T> struct SimdOps : ScalarOps<T> {};
+#endif
+
+template <typename T>
+constexpr uint32_t GROUP_SIZE{ LANES * SimdOps<T>::WIDTH };
+
+// s[n] = x[n] + 2 cos(w) s[n - 1] - s[n - 2] for one group of targets; leaves s[N - 1]
+// and s[N - 2] in s1 and s2
+template <typename T>
+void FilterGroup(const T* samples, uint32_t count, const T* coefficients, T* s1Out, T* s2Out)
+{
+    using V = SimdOps<T>;
+    typename V::Vector c[LANES]{}, s1[LANES]{}, s2[LANES]{};
+    for (uint32_t k{}; k < LANES; ++k) {
+        c[k] = V::Load(coefficients + k * V::WIDTH);
+        s1[k] = V::Set(0);
+        s2[k] = V::Set(0);
+    }
+    for (uint32_t n{}; n < count; ++n) {
+        const typename V::Vector x{ V::Set(samples[n]) };
+        for (uint32_t k{}; k < LANES; ++k) {
+            const typename V::Vector s0{ V::Sub(V::Add(x, V::Mul(c[k], s1[k])), s2[k]) };
+            s2[k] = s1[k];
+            s1[k] = s0;
+        }
+    }
+    for (uint32_t k{}; k < LANES; ++k) {
+        V::Store(s1Out + k * V::WIDTH, s1[k]);
+        V::Store(s2Out + k * V::WIDTH, s2[k]);
+    }
+}
+
+template <MagnitudeMode Mode, typename T>
+void GroupMagnitudes(const T* s1, const T* s2, const T* cosines, const T* sines, uint32_t count, T* dst)
+{
+    // X(w) = e^(jw(N - 1)) (s[N - 1] - e^(-jw) s[N - 2]); the phase does not matter here
+    for (uint32_t i{}; i < count; ++i)
+        dst[i] = EstimateMagnitude<Mode>(std::complex<T>{ s1[i] - cosines[i] * s2[i], sines[i] * s2[i] });
+}
+
+}
+
+template <typename T>
+std::vector<float> GoertzelBank<T>::GetDefaultFrequencies()
+{
+    std::vector<float> frequencies{};
+    for (int semitone{}; semitone < 32; ++semitone)
+        frequencies.push_back(static_cast<float>(220.0 * std::exp2(semitone / 12.0)));
+    return frequencies;
+}
+
+template <typename T>
+uint32_t GoertzelBank<T>::GetBlockSize(uint32_t sampleRate, const std::vector<float>& frequencies)
+{
+    std::vector<float> sorted{ frequencies };
+    std::sort(sorted.begin(), sorted.end());
+
+    double spacing{ sorted.empty() ? sampleRate / 2.0 : sorted[0] };
+    for (size_t i{ 1 }; i < sorted.size(); ++i) {
+        if (sorted[i] > sorted[i - 1])
+            spacing = std::min<double>(spacing, sorted[i] - sorted[i - 1]);
+    }
+    const double size{ std::ceil(RESOLUTION_BINS * sampleRate / spacing) };
+    return static_cast<uint32_t>(std::clamp(size, static_cast<double>(MIN_BLOCK_SIZE), static_cast<double>(MAX_FFT_SIZE)));
+}
+
+template <typename T>
+GoertzelBank<T>::GoertzelBank(uint32_t sampleRate, const std::vector<float>& frequencies) :
+    size{ static_cast<uint32_t>(frequencies.size()) }
+{
+    const uint32_t padded{ (size + GROUP_SIZE<T> - 1) / GROUP_SIZE<T> * GROUP_SIZE<T> };
+    coefficients.resize(padded);
+    cosines.resize(padded);
+    sines.resize(padded, T(1));
+    for (uint32_t i{}; i < size; ++i) {
+        assert(frequencies[i] > 0 && frequencies[i] < sampleRate / 2.f);
+        const double w{ 2 * PI * frequencies[i] / sampleRate };
+        coefficients[i] = static_cast<T>(2 * std::cos(w));
+        cosines[i] = static_cast<T>(std::cos(w));
+        sines[i] = static_cast<T>(std::sin(w));
+    }
+}
+
+template <typename T>
+void GoertzelBank<T>::Process(const T* samples, uint32_t count, MagnitudeMode mode, T* dst) const
+{
+    T s1[GROUP_SIZE<T>]{};
+    T s2[GROUP_SIZE<T>]{};
+    T magnitudes[GROUP_SIZE<T>]{};
+    for (uint32_t group{}; group < size; group += GROUP_SIZE<T>) {
+        FilterGroup(samples, count, coefficients.data() + group, s1, s2);
+
+        const T* c{ cosines.data() + group };
+        const T* s{ sines.data() + group };
+        switch (mode) {
+        case MagnitudeMode::EXACT:
+            GroupMagnitudes<MagnitudeMode::EXACT>(s1, s2, c, s, GROUP_SIZE<T>, magnitudes);
+            break;
+        case MagnitudeMode::POWER:
+            GroupMagnitudes<MagnitudeMode::POWER>(s1, s2, c, s, GROUP_SIZE<T>, magnitudes);
+            break;
+        case MagnitudeMode::FAST:
+            GroupMagnitudes<MagnitudeMode::FAST>(s1, s2, c, s, GROUP_SIZE<T>, magnitudes);
+            break;
+        }
+        std::copy(magnitudes, magnitudes + std::min(GROUP_SIZE<T>, size - group), dst + group);
+    }
+}
+
+template class GoertzelBank<float>;
+template class GoertzelBank<double>;
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Config.h"
+#include "Magnitude.h"
+
+#include <cstdint>
+#include <vector>
+
+// Goertzel filters for a fixed set of frequencies, run side by side so that one pass
+// over a frame updates a whole SIMD vector of targets per sample. The result for a
+// target equals the magnitude of an FFT bin at exactly that frequency, so the window
+// and scale match the FFT path, but nothing else of the spectrum is computed.
+//
+// A frame costs one filter step per target and sample, so the block is only as long as
+// telling the targets apart requires rather than as long as the FFT would be.
+template <typename T>
+class GoertzelBank
+{
+public:
+    // 32 equal-tempered pitches from A3 (220 Hz) to E6 (1319 Hz), for tuning
+    static std::vector<float> GetDefaultFrequencies();
+
+    // Samples per frame: enough that a Blackman-Harris main lobe, RESOLUTION_BINS each
+    // side, fits between neighbouring targets and between the lowest one and DC.
+    // Limited to MIN_BLOCK_SIZE..MAX_FFT_SIZE.
+    static uint32_t GetBlockSize(uint32_t sampleRate, const std::vector<float>& frequencies);
+
+    static constexpr uint32_t RESOLUTION_BINS{ 4 };
+    static constexpr uint32_t MIN_BLOCK_SIZE{ 128 };
+
+public:
+    GoertzelBank(uint32_t sampleRate, const std::vector<float>& frequencies);
+
+    uint32_t GetSize() const { return size; }
+
+    // Magnitudes of every target over `count` windowed samples. Does not modify the
+    // bank, so one bank can serve all channels at once.
+    void Process(const T* samples, uint32_t count, MagnitudeMode mode, T* dst) const;
+
+private:
+    const uint32_t size;
+
+    // Padded to whole groups of SIMD vectors; the padding targets run at a quarter of the rate
+    std::vector<T> coefficients{};  // 2 cos(w)
+    std::vector<T> cosines{};
+    std::vector<T> sines{};
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "RingBuffer.h"
+#include "WindowMultiply.h"
+#include "Magnitude.h"
+#include "PeakHold.h"
+
+#include <cstdint>
+#include <complex>
+#include <cmath>
+#include <algorithm>
+
+// Per-frame analysis stages, templated on the sample type so the engine can
+// run in either precision.
+
+// Reads the frame as (at most) two contiguous ring segments straight into the FFT input
+template <typename T>
+inline void ApplyWindow(const typename RingBuffer<T>::Spans& spans, const T* window, T* dst)
+{
+    const auto& [first, second] { spans };
+    ::MultiplyWindow(first.data, window, dst, first.size);
+    ::MultiplyWindow(second.data, window + first.size, dst + first.size, second.size);
+}
+
+// Windows two real channels into one complex input, a in the real and b in the imaginary part
+template <typename T>
+inline void ApplyWindowPacked(const typename RingBuffer<T>::Spans& a, const typename RingBuffer<T>::Spans& b, 
+                              const T* window, std::complex<T>* dst)
+{
+    // Both channels share the ring's write position, so their spans split at the same index
+    for (uint32_t i{}; i < a.first.size; ++i)
+        dst[i] = { a.first.data[i] * window[i], b.first.data[i] * window[i] };
+    for (uint32_t i{}; i < a.second.size; ++i) {
+        const uint32_t j{ a.first.size + i };
+        dst[j] = { a.second.data[i] * window[j], b.second.data[i] * window[j] };
+    }
+}
+
+// Separates the spectra of a complex FFT over packed real channels a + ib using
+// conjugate symmetry: A[k] = (Z[k] + Z*[N-k]) / 2, B[k] = (Z[k] - Z*[N-k]) / 2i
+template <MagnitudeMode Mode, typename T>
+inline void SplitPackedMagnitudesAs(const std::complex<T>* spectrum, uint32_t size, T* dstA, T* dstB)
+{
+    dstA[0] = EstimateMagnitude<Mode>(std::complex<T>{ spectrum[0].real() });
+    dstB[0] = EstimateMagnitude<Mode>(std::complex<T>{ spectrum[0].imag() });
+    for (uint32_t k{ 1 }; k < size / 2; ++k) {
+        const std::complex<T> z{ spectrum[k] };
+        const std::complex<T> zm{ std::conj(spectrum[size - k]) };
+        dstA[k] = EstimateMagnitude<Mode>((z + zm) / T(2));
+        dstB[k] = EstimateMagnitude<Mode>((z - zm) / T(2));
+    }
+}
+
+template <typename T>
+inline void SplitPackedMagnitudes(const std::complex<T>* spectrum, uint32_t size, T* dstA, T* dstB, MagnitudeMode mode)
+{
+    switch (mode) {
+    case MagnitudeMode::EXACT:
+        SplitPackedMagnitudesAs<MagnitudeMode::EXACT>(spectrum, size, dstA, dstB);
+        break;
+    case MagnitudeMode::POWER:
+        SplitPackedMagnitudesAs<MagnitudeMode::POWER>(spectrum, size, dstA, dstB);
+        break;
+    case MagnitudeMode::FAST:
+        SplitPackedMagnitudesAs<MagnitudeMode::FAST>(spectrum, size, dstA, dstB);
+        break;
+    }
+}
@@ -0,0 +1,132 @@
+#include "LogAnalyzer.h"
+#include "WindowMultiply.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+
+// Octave k covers [OCTAVE_LOW, 2 * OCTAVE_LOW) of its own sample rate
+static constexpr double OCTAVE_LOW{ 0.2 };
+
+uint32_t GetOctave(double frequency, uint32_t sampleRate)
+{
+    uint32_t octave{};
+    while (frequency < OCTAVE_LOW * sampleRate / (1u << octave))
+        ++octave;
+    return octave;
+}
+
+}
+
+template <typename T>
+uint32_t LogAnalyzer<T>::GetFFTSize(uint32_t binsPerOctave)
+{
+    // At the bottom of an octave neighbouring log bins are f * ln2 / binsPerOctave apart;
+    // make that at least one linear bin
+    const double minSize{ binsPerOctave / (OCTAVE_LOW * std::log(2.0)) };
+    uint32_t size{ 64 };
+    while (size < minSize)
+        size *= 2;
+    return size;
+}
+
+template <typename T>
+std::vector<float> LogAnalyzer<T>::GetFrequencies(uint32_t sampleRate, uint32_t binsPerOctave)
+{
+    // Stop one linear bin short of Nyquist in the top octave
+    const uint32_t fftSize{ GetFFTSize(binsPerOctave) };
+    const double maxFrequency{ sampleRate * (0.5 - 1.0 / fftSize) };
+
+    std::vector<float> frequencies{};
+    for (uint32_t j{};; ++j) {
+        const double frequency{ LOG_MIN_FREQUENCY * std::exp2(static_cast<double>(j) / binsPerOctave) };
+        if (frequency >= maxFrequency)
+            break;
+        frequencies.push_back(static_cast<float>(frequency));
+    }
+    return frequencies;
+}
+
+template <typename T>
+std::vector<typename LogAnalyzer<T>::Bin> LogAnalyzer<T>::GetBins(uint32_t sampleRate, uint32_t binsPerOctave)
+{
+    const uint32_t fftSize{ GetFFTSize(binsPerOctave) };
+    const double binSpread{ std::exp2(0.5 / binsPerOctave) };
+
+    std::vector<Bin> bins{};
+    for (const float frequency : GetFrequencies(sampleRate, binsPerOctave)) {
+        Bin bin{};
+        bin.octave = GetOctave(frequency, sampleRate);
+        const double center{ frequency * fftSize * static_cast<double>(1u << bin.octave) / sampleRate };
+        bin.center = static_cast<float>(center);
+        bin.first = static_cast<uint32_t>(std::ceil(center / binSpread));
+        bin.last = std::min(static_cast<uint32_t>(center * binSpread), fftSize / 2 - 1);
+        bins.push_back(bin);
+    }
+    return bins;
+}
+
+template <typename T>
+LogAnalyzer<T>::LogAnalyzer(uint32_t sampleRate, uint32_t binsPerOctave) :
+    fftSize{ GetFFTSize(binsPerOctave) },
+    bins{ GetBins(sampleRate, binsPerOctave) },
+    octaves(bins.empty() ? 1 : bins.front().octave + 1),
+    chain{ std::vector<uint32_t>(octaves.size(), fftSize) },
+    fft{ static_cast<int>(fftSize) }
+{
+    assert(binsPerOctave);
+    fftIn = fft.valueVector();
+    fftOut = fft.spectrumVector();
+    for (auto& octave : octaves)
+        octave.magnitudes = std::vector<T>(fftSize / 2);
+}
+
+template <typename T>
+void LogAnalyzer<T>::Reset()
+{
+    for (auto& octave : octaves) {
+        octave.analyzedAt = 0;
+        octave.isAnalyzed = false;
+    }
+    chain.Reset();
+}
+
+template <typename T>
+void LogAnalyzer<T>::Push(const T* samples, uint32_t count)
+{
+    chain.Push(samples, count);
+}
+
+template <typename T>
+void LogAnalyzer<T>::Analyze(uint32_t, const Window& window, uint32_t hopSize, MagnitudeMode mode, T* dst)
+{
+    for (uint32_t i{}; i < octaves.size(); ++i) {
+        auto& octave{ octaves[i] };
+        const uint64_t written{ chain.GetWritten(i) };
+        if (octave.isAnalyzed && written - octave.analyzedAt < hopSize)
+            continue;
+        ::MultiplyWindow(chain.GetHistory(i), window->data(), fftIn.data(), fftSize);
+        fft.forward(fftIn, fftOut);
+        ::ComputeMagnitudes(fftOut.data(), octave.magnitudes.data(), fftSize / 2, mode);
+        octave.analyzedAt = written;
+        octave.isAnalyzed = true;
+    }
+
+    for (size_t i{}; i < bins.size(); ++i) {
+        const auto& [octave, first, last, center] { bins[i] };
+        const T* magnitudes{ octaves[octave].magnitudes.data() };
+        if (first <= last) {
+            dst[i] = *std::max_element(magnitudes + first, magnitudes + last + 1);
+        }
+        else {
+            const uint32_t index{ std::min(static_cast<uint32_t>(center), fftSize / 2 - 2) };
+            const T fraction{ static_cast<T>(center - index) };
+            dst[i] = magnitudes[index] + fraction * (magnitudes[index + 1] - magnitudes[index]);
+        }
+    }
+}
+
+template class LogAnalyzer<float>;
+template class LogAnalyzer<double>;
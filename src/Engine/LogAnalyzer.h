@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Config.h"
+#include "StreamAnalyzer.h"
+#include "DecimationChain.h"
+
+#include <cstdint>
+#include <vector>
+
+// Constant-Q style analysis of one channel: a fixed number of log-spaced bins per
+// octave between LOG_MIN_FREQUENCY and Nyquist. The input runs through a chain of
+// half-band decimators, and every octave is read from a small FFT at the lowest rate
+// that still holds it, so low frequencies get long windows and high ones short windows
+// while every FFT stays the same size.
+//
+// Octave k is sampled at sampleRate / 2^k and covers [0.2, 0.4) of that rate (octave 0
+// extends to Nyquist). That keeps the decimators' transition band and its aliases
+// outside every octave that is read from it.
+template <typename T>
+class LogAnalyzer final : public StreamAnalyzer<T>
+{
+public:
+    using typename StreamAnalyzer<T>::Window;
+
+    static constexpr float LOG_MIN_FREQUENCY{ 20.f };
+
+    // FFT size per octave; also the number of input samples the top octave looks at.
+    static uint32_t GetFFTSize(uint32_t binsPerOctave);
+    static std::vector<float> GetFrequencies(uint32_t sampleRate, uint32_t binsPerOctave);
+
+public:
+    LogAnalyzer(uint32_t sampleRate, uint32_t binsPerOctave);
+
+    uint32_t GetFFTSize() const { return fftSize; }
+    uint32_t GetResultSize() const override { return static_cast<uint32_t>(bins.size()); }
+
+    void Reset() override;
+    void Push(const T* samples, uint32_t count) override;
+
+    // A single task. An octave is only re-analyzed once it has received `hopSize` new
+    // samples at its own rate; the others keep their last result.
+    void Analyze(uint32_t task, const Window& window, uint32_t hopSize, MagnitudeMode mode, T* dst) override;
+
+private:
+    struct Octave {
+        uint64_t          analyzedAt{};  // Samples written at the last analysis
+        bool              isAnalyzed{};
+        std::vector<T>    magnitudes{};
+    };
+
+    // A log bin reads the maximum of the linear bins [first, last], or interpolates
+    // at `center` when it falls between two of them.
+    struct Bin {
+        uint32_t octave{};
+        uint32_t first{};
+        uint32_t last{};
+        float    center{};
+    };
+
+    static std::vector<Bin> GetBins(uint32_t sampleRate, uint32_t binsPerOctave);
+
+private:
+    const uint32_t fftSize;
+
+    std::vector<Bin>      bins{};
+    std::vector<Octave>   octaves{};
+    DecimationChain<T>    chain;
+
+    FFTInstance<T>       fft;
+    FFTValueVector<T>    fftIn{};
+    FFTSpectrumVector<T> fftOut{};
+};
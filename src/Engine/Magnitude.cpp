@@ -0,0 +1,172 @@
+#include "Magnitude.h"
+
+#if defined(SP_SIMD_AVX2) || defined(SP_SIMD_SSE2)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+#if defined(SP_SIMD_AVX2)
+struct FloatOps {
+    using Vector = __m256;
+    static constexpr uint32_t WIDTH{ 8 };
+
+    // The in-lane shuffle leaves bins as [0 1 4 5 2 3 6 7]; Store puts them back
+    static void LoadComplex(const float* src, Vector& re, Vector& im)
+    {
+        const __m256 a{ _mm256_loadu_ps(src) };
+        const __m256 b{ _mm256_loadu_ps(src + 8) };
+        re = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        im = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+    static void Store(float* dst, Vector v)
+    {
+        _mm256_storeu_ps(dst, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(v), _MM_SHUFFLE(3, 1, 2, 0))));
+    }
+    static Vector Set(float x) { return _mm256_set1_ps(x); }
+    static Vector Add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+    static Vector Mul(Vector a, Vector b) { return _mm256_mul_ps(a, b); }
+    static Vector Sqrt(Vector a) { return _mm256_sqrt_ps(a); }
+    static Vector Abs(Vector a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a); }
+    static Vector Max(Vector a, Vector b) { return _mm256_max_ps(a, b); }
+    static Vector Min(Vector a, Vector b) { return _mm256_min_ps(a, b); }
+};
+
+struct DoubleOps {
+    using Vector = __m256d;
+    static constexpr uint32_t WIDTH{ 4 };
+
+    // Bins come out as [0 2 1 3]; Store puts them back
+    static void LoadComplex(const double* src, Vector& re, Vector& im)
+    {
+        const __m256d a{ _mm256_loadu_pd(src) };
+        const __m256d b{ _mm256_loadu_pd(src + 4) };
+        re = _mm256_unpacklo_pd(a, b);
+        im = _mm256_unpackhi_pd(a, b);
+    }
+    static void Store(double* dst, Vector v) { _mm256_storeu_pd(dst, _mm256_permute4x64_pd(v, _MM_SHUFFLE(3, 1, 2, 0))); }
+    static Vector Set(double x) { return _mm256_set1_pd(x); }
+    static Vector Add(Vector a, Vector b) { return _mm256_add_pd(a, b); }
+    static Vector Mul(Vector a, Vector b) { return _mm256_mul_pd(a, b); }
+    static Vector Sqrt(Vector a) { return _mm256_sqrt_pd(a); }
+    static Vector Abs(Vector a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+    static Vector Max(Vector a, Vector b) { return _mm256_max_pd(a, b); }
+    static Vector Min(Vector a, Vector b) { return _mm256_min_pd(a, b); }
+};
+#elif defined(SP_SIMD_SSE2)
+struct FloatOps {
+    using Vector = __m128;
+    static constexpr uint32_t WIDTH{ 4 };
+
+    static void LoadComplex(const float* src, Vector& re, Vector& im)
+    {
+        const __m128 a{ _mm_loadu_ps(src) };
+        const __m128 b{ _mm_loadu_ps(src + 4) };
+        re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+    static void Store(float* dst, Vector v) { _mm_storeu_ps(dst, v); }
+    static Vector Set(float x) { return _mm_set1_ps(x); }
+    static Vector Add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+    static Vector Mul(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+    static Vector Sqrt(Vector a) { return _mm_sqrt_ps(a); }
+    static Vector Abs(Vector a) { return _mm_andnot_ps(_mm_set1_ps(-0.f), a); }
+    static Vector Max(Vector a, Vector b) { return _mm_max_ps(a, b); }
+    static Vector Min(Vector a, Vector b) { return _mm_min_ps(a, b); }
+};
+
+struct DoubleOps {
+    using Vector = __m128d;
+    static constexpr uint32_t WIDTH{ 2 };
+
+    static void LoadComplex(const double* src, Vector& re, Vector& im)
+    {
+        const __m128d a{ _mm_loadu_pd(src) };
+        const __m128d b{ _mm_loadu_pd(src + 2) };
+        re = _mm_unpacklo_pd(a, b);
+        im = _mm_unpackhi_pd(a, b);
+    }
+    static void Store(double* dst, Vector v) { _mm_storeu_pd(dst, v); }
+    static Vector Set(double x) { return _mm_set1_pd(x); }
+    static Vector Add(Vector a, Vector b) { return _mm_add_pd(a, b); }
+    static Vector Mul(Vector a, Vector b) { return _mm_mul_pd(a, b); }
+    static Vector Sqrt(Vector a) { return _mm_sqrt_pd(a); }
+    static Vector Abs(Vector a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+    static Vector Max(Vector a, Vector b) { return _mm_max_pd(a, b); }
+    static Vector Min(Vector a, Vector b) { return _mm_min_pd(a, b); }
+};
+#endif
+
+#if defined(SP_SIMD_AVX2) || defined(SP_SIMD_SSE2)
+template <typename T> struct SimdOps;
+template <> struct SimdOps<float> : FloatOps {};
+template <> struct SimdOps<double> : DoubleOps {};
+
+template <MagnitudeMode Mode, typename T>
+uint32_t MagnitudeBlocks(const std::complex<T>* spectrum, T* dst, uint32_t count)
+{
+    using V = SimdOps<T>;
+    const T* src{ reinterpret_cast<const T*>(spectrum) };
+
+    uint32_t i{};
+    for (; i + V::WIDTH <= count; i += V::WIDTH) {
+        typename V::Vector re{}, im{};
+        V::LoadComplex(src + 2 * i, re, im);
+        if constexpr (Mode == MagnitudeMode::FAST) {
+            const auto absRe{ V::Abs(re) };
+            const auto absIm{ V::Abs(im) };
+            V::Store(dst + i, V::Add(V::Max(absRe, absIm), V::Mul(V::Min(absRe, absIm), V::Set(T(0.375)))));
+        }
+        else if constexpr (Mode == MagnitudeMode::POWER) {
+            V::Store(dst + i, V::Add(V::Mul(re, re), V::Mul(im, im)));
+        }
+        else {
+            V::Store(dst + i, V::Sqrt(V::Add(V::Mul(re, re), V::Mul(im, im))));
+        }
+    }
+    return i;
+}
+#else
+template <MagnitudeMode Mode, typename T>
+uint32_t MagnitudeBlocks(const std::complex<T>*, T*, uint32_t)
+{
+    return 0;
+}
+#endif
+
+template <MagnitudeMode Mode, typename T>
+void ComputeMagnitudesAs(const std::complex<T>* spectrum, T* dst, uint32_t count)
+{
+    for (uint32_t i{ MagnitudeBlocks<Mode>(spectrum, dst, count) }; i < count; ++i)
+        dst[i] = EstimateMagnitude<Mode>(spectrum[i]);
+    if (count)
+        dst[0] = EstimateMagnitude<Mode>(std::complex<T>{ spectrum[0].real() });
+}
+
+template <typename T>
+void ComputeMagnitudesImpl(const std::complex<T>* spectrum, T* dst, uint32_t count, MagnitudeMode mode)
+{
+    switch (mode) {
+    case MagnitudeMode::EXACT:
+        ComputeMagnitudesAs<MagnitudeMode::EXACT>(spectrum, dst, count);
+        break;
+    case MagnitudeMode::POWER:
+        ComputeMagnitudesAs<MagnitudeMode::POWER>(spectrum, dst, count);
+        break;
+    case MagnitudeMode::FAST:
+        ComputeMagnitudesAs<MagnitudeMode::FAST>(spectrum, dst, count);
+        break;
+    }
+}
+
+}
+
+void ComputeMagnitudes(const std::complex<float>* spectrum, float* dst, uint32_t count, MagnitudeMode mode)
+{
+    ComputeMagnitudesImpl(spectrum, dst, count, mode);
+}
+
+void ComputeMagnitudes(const std::complex<double>* spectrum, double* dst, uint32_t count, MagnitudeMode mode)
+{
+    ComputeMagnitudesImpl(spectrum, dst, count, mode);
+}
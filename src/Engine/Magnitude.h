@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Config.h"
+
+#include <cmath>
+#include <complex>
+#include <algorithm>
+
+enum class MagnitudeMode {
+    EXACT,  // |X|
+    POWER,  // |X|^2, skips the square root
+    FAST    // Alpha-max-beta-min estimate of |X|, within about 7%
+};
+
+template <MagnitudeMode Mode, typename T>
+inline T EstimateMagnitude(const std::complex<T>& c)
+{
+    if constexpr (Mode == MagnitudeMode::EXACT) {
+        return std::abs(c);
+    }
+    else if constexpr (Mode == MagnitudeMode::POWER) {
+        return std::norm(c);
+    }
+    else {
+        const T absRe{ std::abs(c.real()) };
+        const T absIm{ std::abs(c.imag()) };
+        return std::max(absRe, absIm) + 3 * std::min(absRe, absIm) / 8;
+    }
+}
+
+// Magnitudes of the first `count` bins of pffft's ordered real spectrum, which packs
+// the Nyquist bin into the imaginary part of bin 0. The mode is dispatched once per call.
+void ComputeMagnitudes(const std::complex<float>* spectrum, float* dst, uint32_t count, MagnitudeMode mode);
+void ComputeMagnitudes(const std::complex<double>* spectrum, double* dst, uint32_t count, MagnitudeMode mode);
@@ -0,0 +1,120 @@
+#include "MultiResolutionAnalyzer.h"
+#include "WindowMultiply.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace {
+
+// Upper edge of the clean range of a decimation level, as a fraction of its rate
+static constexpr double LEVEL_CLEAN{ 0.4 };
+
+// Smallest FFT a band is allowed to decimate down to
+static constexpr uint32_t MIN_BAND_SIZE{ 64 };
+
+}
+
+template <typename T>
+std::vector<typename MultiResolutionAnalyzer<T>::Band> MultiResolutionAnalyzer<T>::GetBands(uint32_t fftSize)
+{
+    fftSize = std::max(fftSize, MIN_FFT_SIZE);
+
+    std::vector<Band> bands(BAND_COUNT);
+    uint32_t offset{};
+    for (uint32_t k{}; k < BAND_COUNT; ++k) {
+        auto& band{ bands[k] };
+
+        // Band k has the resolution of an fftSize / 4^k point FFT and ends at Nyquist / 4^shift;
+        // the band below ends four times lower
+        const uint32_t shift{ 2 * (BAND_COUNT - 1 - k) };
+        const uint32_t fullSize{ fftSize >> (2 * k) };
+        const double top{ 0.5 / (1u << shift) };
+
+        // Decimate as far as the band stays in the clean range
+        while (top * (2u << band.level) <= LEVEL_CLEAN && (fullSize >> (band.level + 1)) >= MIN_BAND_SIZE)
+            ++band.level;
+
+        band.fftSize = fullSize >> band.level;
+        // Bin indices are the same at the level's rate and at the full rate
+        band.last = fullSize >> (shift + 1);
+        band.first = k ? band.last / 4 : 0;
+        band.offset = offset;
+        offset += band.last - band.first;
+    }
+    return bands;
+}
+
+template <typename T>
+std::vector<float> MultiResolutionAnalyzer<T>::GetFrequencies(uint32_t sampleRate, uint32_t fftSize)
+{
+    std::vector<float> frequencies{};
+    for (const auto& band : GetBands(fftSize)) {
+        const double binWidth{ static_cast<double>(sampleRate) / (band.fftSize << band.level) };
+        for (uint32_t i{ band.first }; i < band.last; ++i)
+            frequencies.push_back(static_cast<float>(i * binWidth));
+    }
+    return frequencies;
+}
+
+template <typename T>
+std::vector<uint32_t> MultiResolutionAnalyzer<T>::GetHistorySizes(const std::vector<Band>& bands)
+{
+    std::vector<uint32_t> sizes{};
+    for (const auto& band : bands) {
+        if (sizes.size() <= band.level)
+            sizes.resize(band.level + 1);
+        sizes[band.level] = std::max(sizes[band.level], band.fftSize);
+    }
+    return sizes;
+}
+
+template <typename T>
+MultiResolutionAnalyzer<T>::MultiResolutionAnalyzer(uint32_t fftSize) :
+    bands{ GetBands(fftSize) },
+    chain{ GetHistorySizes(bands) }
+{
+    // Every band reports what the bottom band's full-rate FFT size would
+    const uint32_t referenceSize{ bands.front().fftSize << bands.front().level };
+    const auto historySizes{ GetHistorySizes(bands) };
+    for (const auto& band : bands) {
+        auto bandFFT{ std::make_unique<BandFFT>(band.fftSize) };
+        bandFFT->in = bandFFT->fft.valueVector();
+        bandFFT->out = bandFFT->fft.spectrumVector();
+        bandFFT->magnitudes = std::vector<T>(band.fftSize / 2);
+        bandFFT->scale = static_cast<T>(referenceSize) / band.fftSize;
+        bandFFT->historyOffset = historySizes[band.level] - band.fftSize;
+        ffts.push_back(std::move(bandFFT));
+    }
+}
+
+template <typename T>
+void MultiResolutionAnalyzer<T>::Reset()
+{
+    chain.Reset();
+}
+
+template <typename T>
+void MultiResolutionAnalyzer<T>::Push(const T* samples, uint32_t count)
+{
+    chain.Push(samples, count);
+}
+
+template <typename T>
+void MultiResolutionAnalyzer<T>::Analyze(uint32_t task, const Window& window, uint32_t, MagnitudeMode mode, T* dst)
+{
+    assert(task < BAND_COUNT);
+    const auto& band{ bands[task] };
+    auto& f{ *ffts[task] };
+
+    ::MultiplyWindow(chain.GetHistory(band.level) + f.historyOffset, window->data(), f.in.data(), band.fftSize);
+    f.fft.forward(f.in, f.out);
+    ::ComputeMagnitudes(f.out.data(), f.magnitudes.data(), band.fftSize / 2, mode);
+
+    const T scale{ mode == MagnitudeMode::POWER ? f.scale * f.scale : f.scale };
+    T* out{ dst + band.offset };
+    for (uint32_t i{ band.first }; i < band.last; ++i)
+        *out++ = f.magnitudes[i] * scale;
+}
+
+template class MultiResolutionAnalyzer<float>;
+template class MultiResolutionAnalyzer<double>;
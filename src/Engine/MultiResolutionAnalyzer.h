@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Config.h"
+#include "StreamAnalyzer.h"
+#include "DecimationChain.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Linear spectrum stitched from BAND_COUNT bands of different resolution. The lowest
+// band has the resolution of a `fftSize` point FFT; every band above it spans two more
+// octaves with a window a quarter as long, up to Nyquist. Each band is read from the
+// most decimated level of a half-band chain that still holds it, so even the longest
+// window is a small FFT, and all bands are re-analyzed at every hop in parallel.
+//
+// For fftSize = 32768 at 48 kHz the bands are [0, 375), [375, 1500), [1500, 6000) and
+// [6000, 24000) Hz with 1.5, 5.9, 23 and 94 Hz bins, all from FFTs of 1024 points or fewer.
+template <typename T>
+class MultiResolutionAnalyzer final : public StreamAnalyzer<T>
+{
+public:
+    using typename StreamAnalyzer<T>::Window;
+
+    static constexpr uint32_t BAND_COUNT{ 4 };
+    static constexpr uint32_t MIN_FFT_SIZE{ 8192 };
+
+    struct Band {
+        uint32_t level{};    // Decimation level the band reads from
+        uint32_t fftSize{};  // At the level's rate
+        uint32_t first{};    // Bins [first, last) of that FFT go to the result
+        uint32_t last{};
+        uint32_t offset{};   // Where they start in the result
+    };
+
+    // `fftSize` is clamped to MIN_FFT_SIZE so that the top band keeps a usable size.
+    static std::vector<Band> GetBands(uint32_t fftSize);
+    static std::vector<float> GetFrequencies(uint32_t sampleRate, uint32_t fftSize);
+
+    // Samples the top band looks at, which is also the hop reference.
+    static uint32_t GetInputSize(uint32_t fftSize) { return GetBands(fftSize).back().fftSize; }
+
+public:
+    explicit MultiResolutionAnalyzer(uint32_t fftSize);
+
+    uint32_t GetResultSize() const override { return bands.back().offset + bands.back().last - bands.back().first; }
+
+    void Reset() override;
+    void Push(const T* samples, uint32_t count) override;
+
+    // One task per band, analyzed with a window of that band's fftSize. Every band is
+    // scaled to the level a single `fftSize` point FFT would report.
+    uint32_t GetTaskCount() const override { return BAND_COUNT; }
+    void Analyze(uint32_t task, const Window& window, uint32_t hopSize, MagnitudeMode mode, T* dst) override;
+
+private:
+    // FFT plans keep internal scratch, so concurrent bands need their own
+    struct BandFFT {
+        explicit BandFFT(uint32_t size) : fft{ static_cast<int>(size) } {}
+
+        FFTInstance<T>       fft;
+        FFTValueVector<T>    in{};
+        FFTSpectrumVector<T> out{};
+        std::vector<T>       magnitudes{};
+        T                    scale{};
+        uint32_t             historyOffset{};  // A level shared with a larger band holds more history
+    };
+
+    static std::vector<uint32_t> GetHistorySizes(const std::vector<Band>& bands);
+
+private:
+    const std::vector<Band>               bands;
+    std::vector<std::unique_ptr<BandFFT>> ffts{};
+    DecimationChain<T>                    chain;
+};
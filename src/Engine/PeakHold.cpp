@@ -0,0 +1,77 @@
+#include "PeakHold.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#if defined(SP_SIMD_AVX2) || defined(SP_SIMD_SSE2)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+template <typename T>
+void UpdateScalar(const T* magnitudes, T* peaks, uint32_t begin, uint32_t end, T decay)
+{
+    for (uint32_t i{ begin }; i < end; ++i)
+        peaks[i] = std::max(magnitudes[i], peaks[i] * decay);
+}
+
+#if defined(SP_SIMD_AVX2)
+inline uint32_t UpdateBlocks(const float* magnitudes, float* peaks, uint32_t count, float decay)
+{
+    const __m256 d{ _mm256_set1_ps(decay) };
+    uint32_t i{};
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(peaks + i, _mm256_max_ps(_mm256_loadu_ps(magnitudes + i), _mm256_mul_ps(_mm256_loadu_ps(peaks + i), d)));
+    return i;
+}
+
+inline uint32_t UpdateBlocks(const double* magnitudes, double* peaks, uint32_t count, double decay)
+{
+    const __m256d d{ _mm256_set1_pd(decay) };
+    uint32_t i{};
+    for (; i + 4 <= count; i += 4)
+        _mm256_storeu_pd(peaks + i, _mm256_max_pd(_mm256_loadu_pd(magnitudes + i), _mm256_mul_pd(_mm256_loadu_pd(peaks + i), d)));
+    return i;
+}
+#elif defined(SP_SIMD_SSE2)
+inline uint32_t UpdateBlocks(const float* magnitudes, float* peaks, uint32_t count, float decay)
+{
+    const __m128 d{ _mm_set1_ps(decay) };
+    uint32_t i{};
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(peaks + i, _mm_max_ps(_mm_loadu_ps(magnitudes + i), _mm_mul_ps(_mm_loadu_ps(peaks + i), d)));
+    return i;
+}
+
+inline uint32_t UpdateBlocks(const double* magnitudes, double* peaks, uint32_t count, double decay)
+{
+    const __m128d d{ _mm_set1_pd(decay) };
+    uint32_t i{};
+    for (; i + 2 <= count; i += 2)
+        _mm_storeu_pd(peaks + i, _mm_max_pd(_mm_loadu_pd(magnitudes + i), _mm_mul_pd(_mm_loadu_pd(peaks + i), d)));
+    return i;
+}
+#endif
+
+template <typename T>
+void UpdatePeaksImpl(const T* magnitudes, T* peaks, uint32_t count, T decay)
+{
+    uint32_t done{};
+#if defined(SP_SIMD_AVX2) || defined(SP_SIMD_SSE2)
+    done = UpdateBlocks(magnitudes, peaks, count, decay);
+#endif
+    UpdateScalar(magnitudes, peaks, done, count, decay);
+}
+
+}
+
+void UpdatePeaks(const float* magnitudes, float* peaks, uint32_t count, float decay)
+{
+    UpdatePeaksImpl(magnitudes, peaks, count, decay);
+}
+
+void UpdatePeaks(const double* magnitudes, double* peaks, uint32_t count, double decay)
+{
+    UpdatePeaksImpl(magnitudes, peaks, count, decay);
+}
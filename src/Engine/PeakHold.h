@@ -0,0 +1,10 @@
+#pragma once
+
+#include "Config.h"
+
+// peaks[i] = max(magnitudes[i], peaks[i] * decay) for `count` bins: held peaks fall
+// exponentially and every frame raises them again, in a single pass. `decay` is the
+// fall over the time since the previous frame, e.g. exp(-rate * elapsed), so it does
+// not matter how many steps that time would have taken.
+void UpdatePeaks(const float* magnitudes, float* peaks, uint32_t count, float decay);
+void UpdatePeaks(const double* magnitudes, double* peaks, uint32_t count, double decay);
@@ -0,0 +1,74 @@
+#include "PlotScale.h"
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+PlotScale::PlotScale(ScaleType scaleType, MagnitudeMode magnitudeMode, float minFrequency, float maxFrequency,
+                     float minHeight, float maxHeight) :
+    scaleType{ scaleType },
+    minFrequency{ minFrequency },
+    maxFrequency{ maxFrequency }
+{
+    assert(minFrequency > 0 && maxFrequency > minFrequency && minHeight > 0 && maxHeight > minHeight);
+
+    // Squared magnitudes span the squared range: in dB that is 10 log10 where magnitudes take 20 log10
+    if (magnitudeMode == MagnitudeMode::POWER) {
+        minHeight *= minHeight;
+        maxHeight *= maxHeight;
+    }
+    if (scaleType != ScaleType::LOGARITHMIC) {
+        heightScale = 1 / (maxHeight - minHeight);
+        heightOffset = -minHeight * heightScale;
+        return;
+    }
+
+    // Each entry holds the position of the middle of its bit range
+    firstIndex = GetIndex(minHeight);
+    logTable.resize(GetIndex(maxHeight) - firstIndex + 1);
+    const double logMin{ std::log(minHeight) };
+    const double logRange{ std::log(maxHeight) - logMin };
+    for (uint32_t i{}; i < logTable.size(); ++i) {
+        const uint32_t bits{ ((firstIndex + i) << INDEX_SHIFT) | (1u << (INDEX_SHIFT - 1)) };
+        float height{};
+        std::memcpy(&height, &bits, sizeof(height));
+        logTable[i] = static_cast<float>(std::clamp((std::log(height) - logMin) / logRange, 0., 1.));
+    }
+}
+
+std::vector<float> PlotScale::MapFrequencies(const std::vector<float>& frequencies) const
+{
+    std::vector<float> positions(frequencies.size());
+    if (scaleType == ScaleType::LINEAR) {
+        for (size_t i{}; i < frequencies.size(); ++i)
+            positions[i] = (frequencies[i] - minFrequency) / (maxFrequency - minFrequency);
+        return positions;
+    }
+
+    // DC has no place on a log axis, so it goes far off to the left
+    const double logMin{ std::log(minFrequency) };
+    const double logRange{ std::log(maxFrequency) - logMin };
+    for (size_t i{}; i < frequencies.size(); ++i) {
+        const float frequency{ std::max(frequencies[i], std::numeric_limits<float>::min()) };
+        positions[i] = static_cast<float>((std::log(frequency) - logMin) / logRange);
+    }
+    return positions;
+}
+
+void PlotScale::MapHeights(const float* heights, float* dst, uint32_t count) const
+{
+    if (logTable.empty()) {
+        for (uint32_t i{}; i < count; ++i)
+            dst[i] = std::clamp(heights[i] * heightScale + heightOffset, 0.f, 1.f);
+        return;
+    }
+    const uint32_t lastIndex{ firstIndex + static_cast<uint32_t>(logTable.size()) - 1 };
+    for (uint32_t i{}; i < count; ++i)
+        dst[i] = logTable[std::clamp(GetIndex(heights[i]), firstIndex, lastIndex) - firstIndex];
+}
+
+void PlotScale::MapHeights(const double* heights, float* dst, uint32_t count) const
+{
+    for (uint32_t i{}; i < count; ++i)
+        dst[i] = MapHeight(static_cast<float>(heights[i]));
+}
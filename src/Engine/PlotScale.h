@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Magnitude.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+enum class ScaleType {
+    LINEAR,            // Linear frequency and magnitude
+    SEMI_LOGARITHMIC,  // Log frequency, linear magnitude
+    LOGARITHMIC        // Log frequency, magnitude in dB
+};
+
+// Where frequencies and magnitudes land on the plot, 0..1 along each axis from the
+// bottom left. Every logarithm is taken up front: bin positions once per layout, and
+// log magnitudes through a table indexed by the top bits of their float representation,
+// so mapping a frame is a gather per point.
+class PlotScale
+{
+public:
+    // minHeight..maxHeight are magnitudes. In MagnitudeMode::POWER heights are squared, and
+    // the axis with them, so the dB axis shows a signal where the other modes do.
+    PlotScale(ScaleType scaleType, MagnitudeMode magnitudeMode, float minFrequency, float maxFrequency,
+              float minHeight, float maxHeight);
+
+    ScaleType GetScaleType() const { return scaleType; }
+
+    // Frequencies outside minFrequency..maxFrequency land outside 0..1
+    std::vector<float> MapFrequencies(const std::vector<float>& frequencies) const;
+
+    // Clamped to 0..1
+    float MapHeight(float height) const;
+    void MapHeights(const float* heights, float* dst, uint32_t count) const;
+    void MapHeights(const double* heights, float* dst, uint32_t count) const;
+
+private:
+    // Mantissa bits kept in a table index: 256 steps per octave, about 0.02 dB apart
+    static constexpr uint32_t INDEX_SHIFT{ 23 - 8 };
+
+    static uint32_t GetIndex(float height)
+    {
+        uint32_t bits{};
+        std::memcpy(&bits, &height, sizeof(bits));
+        return bits >> INDEX_SHIFT;
+    }
+
+private:
+    ScaleType scaleType{};
+    float     minFrequency{};
+    float     maxFrequency{};
+
+    // Linear magnitudes: height * heightScale + heightOffset
+    float heightScale{};
+    float heightOffset{};
+
+    // Log magnitudes: the position of every index from firstIndex up, empty when linear
+    uint32_t           firstIndex{};
+    std::vector<float> logTable{};
+};
+
+inline float PlotScale::MapHeight(float height) const
+{
+    if (logTable.empty())
+        return std::clamp(height * heightScale + heightOffset, 0.f, 1.f);
+
+    // Zero and denormals take the first entry, negative numbers and NaNs the last
+    const uint32_t index{ std::clamp(GetIndex(height), firstIndex, firstIndex + static_cast<uint32_t>(logTable.size()) - 1) };
+    return logTable[index - firstIndex];
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <atomic>
+#include <cassert>
+#include <algorithm>
+
+// Planar multi-channel sample ring shared by one producer (the audio callback)
+// and one consumer (the analysis worker). Neither side ever blocks: the producer
+// overwrites the oldest samples when it laps the consumer, and the consumer
+// validates what it copied against the producer's sequence counters afterwards.
+template <typename T>
+class RingBuffer
+{
+public:
+    struct Span {
+        const T* data{};
+        uint32_t size{};
+    };
+
+    // A logical range of the ring split at the wrap point.
+    struct Spans {
+        Span first{};
+        Span second{};
+    };
+
+    // Physical indices covered by a write, split at the wrap point.
+    struct Region {
+        uint32_t offset{};
+        uint32_t first{};
+        uint32_t second{};
+    };
+
+public:
+    RingBuffer(uint32_t channelCount, uint32_t capacity) :
+        capacity{ capacity }, mask{ capacity - 1 }, data(channelCount)
+    {
+        assert(capacity && !(capacity & (capacity - 1)) && "Capacity must be a power of two");
+        for (auto& d : data)
+            d = std::vector<T>(capacity);
+    }
+
+    uint32_t Capacity() const { return capacity; }
+
+    // Producer side
+    T* Data(uint32_t channel) { return data[channel].data(); }
+
+    Region BeginWrite(uint32_t count)
+    {
+        assert(count <= capacity);
+        const uint64_t seq{ writeSeq.load(std::memory_order_relaxed) };
+        claimSeq.store(seq + count, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        const uint32_t offset{ static_cast<uint32_t>(seq) & mask };
+        const uint32_t first{ std::min(count, capacity - offset) };
+        return { offset, first, count - first };
+    }
+
+    void EndWrite(uint32_t count)
+    {
+        writeSeq.store(writeSeq.load(std::memory_order_relaxed) + count, std::memory_order_release);
+    }
+
+    // Consumer side
+    uint64_t WriteSequence() const { return writeSeq.load(std::memory_order_acquire); }
+
+    // Returns the samples [end - count, end) of a channel as up to two contiguous spans.
+    Spans Peek(uint32_t channel, uint64_t end, uint32_t count) const
+    {
+        assert(count <= capacity && end >= count);
+        const T* base{ data[channel].data() };
+        const uint32_t offset{ static_cast<uint32_t>(end - count) & mask };
+        const uint32_t first{ std::min(count, capacity - offset) };
+        return { { base + offset, first }, { base, count - first } };
+    }
+
+    // Call after copying out of Peek(); false if the producer may have
+    // overwritten anything at or after `start` in the meantime.
+    bool IsIntact(uint64_t start) const
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return claimSeq.load(std::memory_order_relaxed) <= start + capacity;
+    }
+
+private:
+    const uint32_t capacity{};
+    const uint32_t mask{};
+    std::vector<std::vector<T>> data{};
+
+    alignas(64) std::atomic<uint64_t> writeSeq{};
+    alignas(64) std::atomic<uint64_t> claimSeq{};
+};
@@ -0,0 +1,286 @@
+#include "SlidingDFT.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#if defined(SP_SIMD_AVX2) || defined(SP_SIMD_SSE2)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+static constexpr double PI{ 3.14159265358979323846 };
+
+// Samples slid through the bins per pass, so the bin state stays in registers
+static constexpr uint32_t SLIDE_BLOCK{ 64 };
+
+#if defined(SP_SIMD_AVX2)
+struct FloatOps {
+    using Vector = __m256;
+    static constexpr uint32_t WIDTH{ 8 };
+    static Vector Load(const float* src) { return _mm256_loadu_ps(src); }
+    static void Store(float* dst, Vector v) { _mm256_storeu_ps(dst, v); }
+    static Vector Set(float x) { return _mm256_set1_ps(x); }
+    static Vector Add(Vector a, Vector b) { return _mm256_add_ps(a, b); }
+    static Vector Sub(Vector a, Vector b) { return _mm256_sub_ps(a, b); }
+    static Vector Mul(Vector a, Vector b) { return _mm256_mul_ps(a, b); }
+};
+
+struct DoubleOps {
+    using Vector = __m256d;
+    static constexpr uint32_t WIDTH{ 4 };
+    static Vector Load(const double* src) { return _mm256_loadu_pd(src); }
+    static void Store(double* dst, Vector v) { _mm256_storeu_pd(dst, v); }
+    static Vector Set(double x) { return _mm256_set1_pd(x); }
+    static Vector Add(Vector a, Vector b) { return _mm256_add_pd(a, b); }
+    static Vector Sub(Vector a, Vector b) { return _mm256_sub_pd(a, b); }
+    static Vector Mul(Vector a, Vector b) { return _mm256_mul_pd(a, b); }
+};
+#elif defined(SP_SIMD_SSE2)
+struct FloatOps {
+    using Vector = __m128;
+    static constexpr uint32_t WIDTH{ 4 };
+    static Vector Load(const float* src) { return _mm_loadu_ps(src); }
+    static void Store(float* dst, Vector v) { _mm_storeu_ps(dst, v); }
+    static Vector Set(float x) { return _mm_set1_ps(x); }
+    static Vector Add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+    static Vector Sub(Vector a, Vector b) { return _mm_sub_ps(a, b); }
+    static Vector Mul(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+};
+
+struct DoubleOps {
+    using Vector = __m128d;
+    static constexpr uint32_t WIDTH{ 2 };
+    static Vector Load(const double* src) { return _mm_loadu_pd(src); }
+    static void Store(double* dst, Vector v) { _mm_storeu_pd(dst, v); }
+    static Vector Set(double x) { return _mm_set1_pd(x); }
+    static Vector Add(Vector a, Vector b) { return _mm_add_pd(a, b); }
+    static Vector Sub(Vector a, Vector b) { return _mm_sub_pd(a, b); }
+    static Vector Mul(Vector a, Vector b) { return _mm_mul_pd(a, b); }
+};
+#endif
+
+#if defined(SP_SIMD_AVX2) || defined(SP_SIMD_SSE2)
+template <typename T> struct SimdOps;
+template <> struct SimdOps<float> : FloatOps {};
+template <> struct SimdOps<double> : DoubleOps {};
+
+// Two vectors of bins at a time, since every sample depends on the previous one
+template <typename T>
+uint32_t SlideBlocks(T* re, T* im, const T* twRe, const T* twIm, uint32_t count, const T* deltas, uint32_t sampleCount)
+{
+    using V = SimdOps<T>;
+    static constexpr uint32_t STEP{ 2 * V::WIDTH };
+
+    uint32_t i{};
+    for (; i + STEP <= count; i += STEP) {
+        typename V::Vector r0{ V::Load(re + i) }, r1{ V::Load(re + i + V::WIDTH) };
+        typename V::Vector m0{ V::Load(im + i) }, m1{ V::Load(im + i + V::WIDTH) };
+        const typename V::Vector c0{ V::Load(twRe + i) }, c1{ V::Load(twRe + i + V::WIDTH) };
+        const typename V::Vector s0{ V::Load(twIm + i) }, s1{ V::Load(twIm + i + V::WIDTH) };
+        for (uint32_t j{}; j < sampleCount; ++j) {
+            const typename V::Vector d{ V::Set(deltas[j]) };
+            const typename V::Vector a0{ V::Add(r0, d) }, a1{ V::Add(r1, d) };
+            r0 = V::Sub(V::Mul(a0, c0), V::Mul(m0, s0));
+            r1 = V::Sub(V::Mul(a1, c1), V::Mul(m1, s1));
+            m0 = V::Add(V::Mul(a0, s0), V::Mul(m0, c0));
+            m1 = V::Add(V::Mul(a1, s1), V::Mul(m1, c1));
+        }
+        V::Store(re + i, r0);
+        V::Store(re + i + V::WIDTH, r1);
+        V::Store(im + i, m0);
+        V::Store(im + i + V::WIDTH, m1);
+    }
+    return i;
+}
+#else
+template <typename T>
+uint32_t SlideBlocks(T*, T*, const T*, const T*, uint32_t, const T*, uint32_t)
+{
+    return 0;
+}
+#endif
+
+// X_k <- (X_k + new - old) e^(j 2 pi k / N) for every bin and sample
+template <typename T>
+void SlideBins(T* re, T* im, const T* twRe, const T* twIm, uint32_t count, const T* deltas, uint32_t sampleCount)
+{
+    for (uint32_t i{ SlideBlocks(re, im, twRe, twIm, count, deltas, sampleCount) }; i < count; ++i) {
+        T r{ re[i] };
+        T m{ im[i] };
+        for (uint32_t j{}; j < sampleCount; ++j) {
+            const T a{ r + deltas[j] };
+            r = a * twRe[i] - m * twIm[i];
+            m = a * twIm[i] + m * twRe[i];
+        }
+        re[i] = r;
+        im[i] = m;
+    }
+}
+
+}
+
+template <typename T>
+std::vector<uint32_t> SlidingDFT<T>::GetBins(uint32_t sampleRate, uint32_t fftSize, uint32_t binsPerOctave)
+{
+    // Every target needs its whole kernel neighbourhood below Nyquist
+    const uint32_t maxBin{ fftSize / 2 - 1 - KERNEL_RADIUS };
+
+    std::vector<uint32_t> bins{};
+    for (uint32_t j{};; ++j) {
+        const double frequency{ MIN_FREQUENCY * std::exp2(static_cast<double>(j) / binsPerOctave) };
+        const auto bin{ static_cast<uint32_t>(std::lround(frequency * fftSize / sampleRate)) };
+        if (bin > maxBin)
+            break;
+        if (bin >= KERNEL_RADIUS && (bins.empty() || bin != bins.back()))
+            bins.push_back(bin);
+    }
+    return bins;
+}
+
+template <typename T>
+std::vector<float> SlidingDFT<T>::GetFrequencies(uint32_t sampleRate, uint32_t fftSize, uint32_t binsPerOctave)
+{
+    std::vector<float> frequencies{};
+    for (const uint32_t bin : GetBins(sampleRate, fftSize, binsPerOctave))
+        frequencies.push_back(static_cast<float>(bin) * sampleRate / fftSize);
+    return frequencies;
+}
+
+template <typename T>
+SlidingDFT<T>::SlidingDFT(uint32_t sampleRate, uint32_t fftSize, uint32_t binsPerOctave) :
+    fftSize{ fftSize },
+    history(2 * fftSize),
+    deltas(SLIDE_BLOCK),
+    fft{ static_cast<int>(fftSize) }
+{
+    assert((fftSize & (fftSize - 1)) == 0 && binsPerOctave);
+    fftIn = fft.valueVector();
+    fftOut = fft.spectrumVector();
+
+    for (const uint32_t bin : GetBins(sampleRate, fftSize, binsPerOctave)) {
+        for (uint32_t b{ bin - KERNEL_RADIUS }; b <= bin + KERNEL_RADIUS; ++b) {
+            if (trackedBins.empty() || b > trackedBins.back())
+                trackedBins.push_back(b);
+        }
+        targets.push_back(static_cast<uint32_t>(trackedBins.size()) - KERNEL_SIZE);
+    }
+
+    re.resize(trackedBins.size());
+    im.resize(trackedBins.size());
+    for (const uint32_t bin : trackedBins) {
+        twiddleRe.push_back(static_cast<T>(std::cos(2 * PI * bin / fftSize)));
+        twiddleIm.push_back(static_cast<T>(std::sin(2 * PI * bin / fftSize)));
+    }
+}
+
+template <typename T>
+void SlidingDFT<T>::Reset()
+{
+    std::fill(history.begin(), history.end(), T{});
+    std::fill(re.begin(), re.end(), T{});
+    std::fill(im.begin(), im.end(), T{});
+    position = 0;
+    sinceResync = 0;
+}
+
+template <typename T>
+void SlidingDFT<T>::Push(const T* samples, uint32_t count)
+{
+    // Sliding through a whole window costs more than transforming it
+    if (count >= fftSize) {
+        samples += count - fftSize;
+        std::copy(samples, samples + fftSize, history.begin());
+        std::copy(samples, samples + fftSize, history.begin() + fftSize);
+        position = 0;
+        Resync();
+        return;
+    }
+
+    while (count) {
+        const uint32_t n{ std::min({ count, SLIDE_BLOCK, fftSize - sinceResync }) };
+        for (uint32_t j{}; j < n; ++j) {
+            deltas[j] = samples[j] - history[position];
+            history[position] = history[position + fftSize] = samples[j];
+            position = (position + 1) & (fftSize - 1);
+        }
+        SlideBins(re.data(), im.data(), twiddleRe.data(), twiddleIm.data(), static_cast<uint32_t>(re.size()),
+                  deltas.data(), n);
+
+        samples += n;
+        count -= n;
+        sinceResync += n;
+        if (sinceResync == fftSize)
+            Resync();
+    }
+}
+
+template <typename T>
+void SlidingDFT<T>::Resync()
+{
+    std::copy(history.begin() + position, history.begin() + position + fftSize, fftIn.begin());
+    fft.forward(fftIn, fftOut);
+    for (size_t i{}; i < trackedBins.size(); ++i) {
+        re[i] = fftOut[trackedBins[i]].real();
+        im[i] = fftOut[trackedBins[i]].imag();
+    }
+    // Bin 0 holds Nyquist in its imaginary part; DC itself is real
+    if (!trackedBins.empty() && trackedBins[0] == 0)
+        im[0] = 0;
+    sinceResync = 0;
+}
+
+template <typename T>
+void SlidingDFT<T>::UpdateKernel(const Window& window)
+{
+    assert(window->size() == fftSize);
+    kernelWindow = window;
+    std::copy(window->begin(), window->end(), fftIn.begin());
+    fft.forward(fftIn, fftOut);
+
+    // x w transforms to X circularly convolved with W / N, and W_-j = conj(W_j) for a
+    // real window. Bin 0 holds Nyquist in its imaginary part.
+    const T scale{ T(1) / fftSize };
+    kernel[KERNEL_RADIUS] = fftOut[0].real() * scale;
+    for (uint32_t j{ 1 }; j <= KERNEL_RADIUS; ++j) {
+        kernel[KERNEL_RADIUS - j] = fftOut[j] * scale;
+        kernel[KERNEL_RADIUS + j] = std::conj(fftOut[j]) * scale;
+    }
+}
+
+template <typename T>
+template <MagnitudeMode Mode>
+void SlidingDFT<T>::Evaluate(T* dst) const
+{
+    for (size_t i{}; i < targets.size(); ++i) {
+        const T* r{ re.data() + targets[i] };
+        const T* m{ im.data() + targets[i] };
+        std::complex<T> sum{};
+        for (uint32_t j{}; j < KERNEL_SIZE; ++j)
+            sum += kernel[j] * std::complex<T>{ r[j], m[j] };
+        dst[i] = EstimateMagnitude<Mode>(sum);
+    }
+}
+
+template <typename T>
+void SlidingDFT<T>::Analyze(uint32_t, const Window& window, uint32_t, MagnitudeMode mode, T* dst)
+{
+    if (window != kernelWindow)
+        UpdateKernel(window);
+
+    switch (mode) {
+    case MagnitudeMode::EXACT:
+        Evaluate<MagnitudeMode::EXACT>(dst);
+        break;
+    case MagnitudeMode::POWER:
+        Evaluate<MagnitudeMode::POWER>(dst);
+        break;
+    case MagnitudeMode::FAST:
+        Evaluate<MagnitudeMode::FAST>(dst);
+        break;
+    }
+}
+
+template class SlidingDFT<float>;
+template class SlidingDFT<double>;
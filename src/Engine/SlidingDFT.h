@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Config.h"
+#include "StreamAnalyzer.h"
+
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+// Sliding DFT over a few bins of an fftSize point DFT: every new sample updates each
+// tracked bin in O(1), so results can be read at any hop without a transform. The
+// targets are the DFT bins nearest to binsPerOctave log-spaced frequencies from 20 Hz.
+//
+// The window is applied in the frequency domain as a convolution with its own DFT,
+// truncated to KERNEL_RADIUS bins either side. That is exact for the cosine-sum windows
+// of up to four terms and within a few percent of the peak for the others. Rounding in the recursion
+// is wiped out by recomputing the tracked bins with a full FFT of the history once
+// every fftSize samples.
+template <typename T>
+class SlidingDFT final : public StreamAnalyzer<T>
+{
+public:
+    using typename StreamAnalyzer<T>::Window;
+
+    static constexpr float    MIN_FREQUENCY{ 20.f };
+    static constexpr uint32_t KERNEL_RADIUS{ 3 };
+
+    // Updates cost the same whatever the hop, so hops are a fraction of this rather
+    // than of the window length.
+    static constexpr uint32_t HOP_SIZE_BASE{ 256 };
+
+    static std::vector<uint32_t> GetBins(uint32_t sampleRate, uint32_t fftSize, uint32_t binsPerOctave);
+    static std::vector<float> GetFrequencies(uint32_t sampleRate, uint32_t fftSize, uint32_t binsPerOctave);
+
+public:
+    SlidingDFT(uint32_t sampleRate, uint32_t fftSize, uint32_t binsPerOctave);
+
+    uint32_t GetResultSize() const override { return static_cast<uint32_t>(targets.size()); }
+
+    void Reset() override;
+    void Push(const T* samples, uint32_t count) override;
+
+    // A single task; `window` must be fftSize long and is only transformed when it changes.
+    void Analyze(uint32_t task, const Window& window, uint32_t hopSize, MagnitudeMode mode, T* dst) override;
+
+private:
+    void Resync();
+    void UpdateKernel(const Window& window);
+    template <MagnitudeMode Mode>
+    void Evaluate(T* dst) const;
+
+private:
+    static constexpr uint32_t KERNEL_SIZE{ 2 * KERNEL_RADIUS + 1 };
+
+    const uint32_t fftSize;
+
+    // Tracked bins hold every target's neighbourhood, so target i reads the
+    // KERNEL_SIZE consecutive entries from targets[i] on
+    std::vector<uint32_t> trackedBins{};
+    std::vector<uint32_t> targets{};
+    std::vector<T>        re{};
+    std::vector<T>        im{};
+    std::vector<T>        twiddleRe{};
+    std::vector<T>        twiddleIm{};
+
+    std::vector<T> history{};  // Last fftSize samples, written twice so they read contiguously
+    uint32_t       position{};
+    uint32_t       sinceResync{};
+    std::vector<T> deltas{};
+
+    // Held so the table cannot be freed and another one take its address
+    Window          kernelWindow{};
+    std::complex<T> kernel[KERNEL_SIZE]{};
+
+    FFTInstance<T>       fft;
+    FFTValueVector<T>    fftIn{};
+    FFTSpectrumVector<T> fftOut{};
+};
@@ -0,0 +1,13 @@
+#include "SpectrumEngine.h"
+#include "SpectrumEngineImpl.h"
+
+std::unique_ptr<SpectrumEngine> SpectrumEngine::Create(const Settings& settings)
+{
+    switch (settings.precision) {
+    case Precision::F64:
+        return std::make_unique<SpectrumEngineImpl<double>>(settings);
+    case Precision::F32:
+    default:
+        return std::make_unique<SpectrumEngineImpl<float>>(settings);
+    }
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "Config.h"
+#include "Magnitude.h"
+#include "FFTWindow.h"
+#include "PlotScale.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <functional>
+
+// Headless analysis pipeline: samples are pushed in from any real-time thread,
+// analyzed once per hop (either by Process() or by the owned worker thread), and
+// the latest peak-held spectrum is pulled out by the front end.
+//
+// The pipeline runs in the precision chosen at creation; results always come out as float.
+class SpectrumEngine
+{
+public:
+    enum class Precision {
+        F32,
+        F64
+    };
+
+    using MagnitudeMode = ::MagnitudeMode;
+
+    using WindowType = ::WindowType;
+
+    using ScaleType = ::ScaleType;
+
+    enum class AnalyzerType {
+        FFT,              // Linearly spaced bins from one FFT of GetFFTSize()
+        LOG_FREQUENCY,    // A fixed number of bins per octave, see LogAnalyzer
+        MULTI_RESOLUTION, // Linear bands, finest at the bottom; see MultiResolutionAnalyzer
+        SLIDING_DFT,      // Log-spaced bins of one FFT, updated every sample; see SlidingDFT
+        GOERTZEL_BANK     // Only the target frequencies, over just enough samples to tell them apart; see GoertzelBank
+    };
+
+    struct Settings {
+        Precision  precision{ Precision::F32 };
+        uint32_t   channelCount{ DEFAULT_CHANNEL_COUNT };
+        uint32_t   sampleRate{ DEFAULT_SAMPLE_RATE };
+        uint32_t   fftSize{ MAX_FFT_SIZE };
+        float      overlap{ 0.5f };
+        WindowType windowType{ WindowType::BLACKMAN_HARRIS };
+        // Kaiser beta or Gaussian sigma; 0 picks the window's default
+        float      windowParameter{};
+        MagnitudeMode magnitudeMode{ MagnitudeMode::EXACT };
+        // Analyze channel pairs with one complex FFT instead of two real ones
+        bool       stereoPacking{};
+        AnalyzerType analyzerType{ AnalyzerType::FFT };
+        uint32_t   binsPerOctave{ DEFAULT_BINS_PER_OCTAVE };
+        // GOERTZEL_BANK targets in Hz, those at or above Nyquist dropped; none left picks
+        // GoertzelBank's default pitches
+        std::vector<float> targetFrequencies{};
+        // Pixel columns of the plot that frames are reduced to; 0 keeps every bin
+        uint32_t   plotColumns{};
+        ScaleType  scaleType{ ScaleType::LOGARITHMIC };
+        // Held peaks fall by exp(-FALL_RATE * fallSpeed) per second
+        float      fallSpeed{ .1f };
+    };
+
+    struct Stats {
+        uint64_t analyzed{};
+        uint64_t dropped{};
+        uint64_t coalesced{};
+    };
+
+    // Peak-held spectra in plot coordinates, 0..1 along the axes of GetScaleType():
+    // `positions` from the lowest positive bin to Nyquist, `heights` from PLOT_MIN_HEIGHT
+    // to PLOT_MAX_HEIGHT, squared for MagnitudeMode::POWER. Decimated to the plot's
+    // columns, see ColumnDecimator.
+    struct Frame {
+        uint64_t sequence{};
+        std::vector<float> positions{};
+        std::vector<std::vector<float>> heights{};
+        // A waterfall row: the colormap index of every plot column, along the same height
+        // axis, for the loudest channel. Empty without plot columns.
+        std::vector<uint8_t> levels{};
+    };
+
+    // Invoked on the analyzing thread with the raw magnitudes of every frame.
+    using FrameCallback = std::function<void(uint64_t frameEnd, 
+                                             const std::vector<std::vector<float>>& magnitudes)>;
+
+    // Invoked on the analyzing thread with every frame PullFrame() would return, e.g. to
+    // write it straight into GPU memory.
+    using PlotCallback = std::function<void(const Frame& frame)>;
+
+public:
+    static std::unique_ptr<SpectrumEngine> Create(const Settings& settings);
+    virtual ~SpectrumEngine() = default;
+
+    // Real-time safe; takes interleaved f32 frames of GetChannelCount() channels.
+    virtual void PushSamples(const float* samples, uint32_t frameCount) = 0;
+
+    // Analyzes every hop that is due and returns the number of frames produced. Without
+    // `isPlotting` only `onFrame` sees them: held peaks, PullFrame() and the plot callback
+    // are left as they were.
+    virtual uint32_t Process(const FrameCallback& onFrame = {}, bool isPlotting = true) = 0;
+    virtual void Start() = 0;
+    virtual void Stop() = 0;
+
+    // Copies the newest spectrum; false if nothing was analyzed since `frame.sequence`.
+    // Held peaks fall at GetFallSpeed() over the input's time between frames. Never
+    // blocks the analysis, but only one thread may pull frames.
+    virtual bool PullFrame(Frame& frame) = 0;
+    // Only while stopped
+    virtual void SetPlotCallback(PlotCallback onPlot) = 0;
+
+    // Reconfiguration never blocks: the new setup is built on a background thread and
+    // takes effect from the next frame. Getters report the most recent request.
+    virtual void Reset(uint32_t fftSize) = 0;
+    virtual void SetWindow(WindowType windowType, float windowParameter = 0) = 0;
+    virtual void SetOverlap(float overlap) = 0;
+    virtual void SetStereoPacking(bool stereoPacking) = 0;
+    virtual void SetMagnitudeMode(MagnitudeMode magnitudeMode) = 0;
+    virtual void SetAnalyzer(AnalyzerType analyzerType, uint32_t binsPerOctave = DEFAULT_BINS_PER_OCTAVE) = 0;
+    virtual void SetTargetFrequencies(const std::vector<float>& targetFrequencies) = 0;
+    virtual void SetPlotColumns(uint32_t plotColumns) = 0;
+    virtual void SetScaleType(ScaleType scaleType) = 0;
+    virtual void SetFallSpeed(float fallSpeed) = 0;
+
+    Precision GetPrecision() const { return precision; }
+    uint32_t GetChannelCount() const { return channelCount; }
+    uint32_t GetSampleRate() const { return sampleRate; }
+    float GetBinFrequency(uint32_t bin) const { return frequencies[bin]; }
+    const std::vector<float>& GetFrequencies() const { return frequencies; }
+    uint32_t GetFFTSize() const { return fftSize; }
+    uint32_t GetResultSize() const { return fftResultSize; }
+    uint32_t GetHopSize() const { return hopSize; }
+    float GetOverlap() const { return overlap; }
+    WindowType GetWindowType() const { return windowType; }
+    float GetWindowParameter() const { return windowParameter; }
+    bool GetStereoPacking() const { return stereoPacking; }
+    MagnitudeMode GetMagnitudeMode() const { return magnitudeMode; }
+    AnalyzerType GetAnalyzerType() const { return analyzerType; }
+    uint32_t GetBinsPerOctave() const { return binsPerOctave; }
+    const std::vector<float>& GetTargetFrequencies() const { return targetFrequencies; }
+    uint32_t GetPlotColumns() const { return plotColumns; }
+    ScaleType GetScaleType() const { return scaleType; }
+    float GetFallSpeed() const { return fallSpeed; }
+    Stats GetStats() const { return { framesAnalyzed, framesDropped, framesCoalesced }; }
+
+protected:
+    explicit SpectrumEngine(const Settings& settings) :
+        precision{ settings.precision },
+        channelCount{ settings.channelCount },
+        sampleRate{ settings.sampleRate },
+        overlap{ settings.overlap },
+        windowType{ settings.windowType },
+        windowParameter{ settings.windowParameter ? settings.windowParameter : GetDefaultWindowParameter(settings.windowType) },
+        stereoPacking{ settings.stereoPacking },
+        magnitudeMode{ settings.magnitudeMode },
+        analyzerType{ settings.analyzerType },
+        binsPerOctave{ settings.binsPerOctave },
+        plotColumns{ settings.plotColumns },
+        scaleType{ settings.scaleType },
+        fallSpeed{ settings.fallSpeed }
+    {
+    }
+
+protected:
+    const Precision precision{};
+    const uint32_t  channelCount{};
+    const uint32_t  sampleRate{};
+    uint32_t fftSize{};
+    uint32_t fftResultSize{};
+    uint32_t hopSize{};
+    float    overlap{};
+    WindowType windowType{};
+    float    windowParameter{};
+    bool     stereoPacking{};
+    MagnitudeMode magnitudeMode{};
+    AnalyzerType  analyzerType{};
+    uint32_t      binsPerOctave{};
+    std::vector<float> targetFrequencies{};
+    uint32_t           plotColumns{};
+    ScaleType          scaleType{};
+    float              fallSpeed{};
+    std::vector<float> frequencies{};
+
+    std::atomic<uint64_t> framesAnalyzed{};
+    std::atomic<uint64_t> framesDropped{};
+    std::atomic<uint64_t> framesCoalesced{};
+};
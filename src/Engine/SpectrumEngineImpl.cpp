@@ -0,0 +1,711 @@
+#include "SpectrumEngineImpl.h"
+
+#include "FFTWindow.h"
+#include "Deinterleave.h"
+#include "Kernels.h"
+#include "LogAnalyzer.h"
+#include "MultiResolutionAnalyzer.h"
+#include "SlidingDFT.h"
+
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+#include <chrono>
+
+template <typename T>
+SpectrumEngineImpl<T>::SpectrumEngineImpl(const Settings& settings) :
+    SpectrumEngine{ settings },
+    heights(settings.channelCount),
+    frameMagnitudes(settings.precision == Precision::F32 ? 0 : settings.channelCount),
+    sampleRing{ settings.channelCount, SAMPLE_RING_SIZE },
+    workerPool{ std::min(settings.channelCount, std::max(std::thread::hardware_concurrency(), 1u)) - 1 }
+{
+    assert(channelCount && channelCount <= MAX_CHANNEL_COUNT);
+    assert(sampleRate);
+    assert(settings.fftSize >= 128 && settings.fftSize <= MAX_FFT_SIZE);
+
+    assert(binsPerOctave);
+
+    fftSize = settings.fftSize;
+    UpdateTargets(settings.targetFrequencies);
+    UpdateSizes();
+
+    // The first state is built synchronously so the engine is usable right away
+    auto initial{ CreateState(GetConfig(), nullptr) };
+    stateGeneration = initial->generation;
+    ResetPeaks(*initial);
+    state = initial.release();
+
+    builderThread = std::thread{ Builder, this };
+}
+
+template <typename T>
+SpectrumEngineImpl<T>::~SpectrumEngineImpl()
+{
+    Stop();
+    {
+        std::lock_guard lock{ builderMutex };
+        isBuilderRunning = false;
+    }
+    builderCond.notify_all();
+    builderThread.join();
+    delete state.exchange(nullptr);
+}
+
+template <typename T>
+void SpectrumEngineImpl<T>::PushSamples(const float* samples, uint32_t frameCount)
+{
+    auto& ring{ sampleRing };
+
+    // Only the newest samples matter if a single push overflows the ring
+    if (frameCount > ring.Capacity()) {
+        samples += (frameCount - ring.Capacity()) * channelCount;
+        frameCount = ring.Capacity();
+    }
+
+    // At most two block copies: up to the wrap point, then from the start of the ring
+    const auto region{ ring.BeginWrite(frameCount) };
+    T* dst[MAX_CHANNEL_COUNT]{};
+    for (uint32_t channel{}; channel < channelCount; ++channel)
+        dst[channel] = ring.Data(channel) + region.offset;
+    ::Deinterleave(samples, channelCount, dst, region.first);
+
+    if (region.second) {
+        for (uint32_t channel{}; channel < channelCount; ++channel)
+            dst[channel] = ring.Data(channel);
+        ::Deinterleave(samples + region.first * channelCount, channelCount, dst, region.second);
+    }
+    ring.EndWrite(frameCount);
+
+    // Only a worker waiting for a due frame gets woken. The fence pairs with the worker's,
+    // so either it sees these samples or we see its request; a notify it misses before
+    // blocking is repeated by the next push.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ring.WriteSequence() >= wakeSequence.load(std::memory_order_relaxed))
+        sampleAvailCond.notify_one();
+}
+
+template <typename T>
+uint32_t SpectrumEngineImpl<T>::Process(const FrameCallback& onFrame, bool isPlotting)
+{
+    std::lock_guard l{ fftBusyMutex };
+    const auto guard{ stateReclaimer.Pin(0) };
+    const AnalysisState& current{ *state.load() };
+    const uint32_t frameSize{ current.inputSize };
+    const uint32_t hop{ current.hopSize };
+
+    // Peaks carry over unless the bins moved
+    if (current.generation != stateGeneration) {
+        if (*current.frequencies != *peakFrequencies)
+            ResetPeaks(current);
+        stateGeneration = current.generation;
+    }
+
+    const uint64_t written{ sampleRing.WriteSequence() };
+
+    // First frame, or the FFT grew past the next scheduled position
+    nextFrameEnd = std::max<uint64_t>(nextFrameEnd, frameSize);
+    if (written < nextFrameEnd)
+        return 0;
+
+    // One frame per hop; when we fell behind, catch up on at most
+    // MAX_CATCHUP_FRAMES of the newest hops and drop the rest
+    uint64_t pending{ (written - nextFrameEnd) / hop + 1 };
+    if (pending > MAX_CATCHUP_FRAMES) {
+        framesDropped += pending - MAX_CATCHUP_FRAMES;
+        nextFrameEnd += (pending - MAX_CATCHUP_FRAMES) * hop;
+        pending = MAX_CATCHUP_FRAMES;
+    }
+    framesCoalesced += pending - 1;
+
+    const auto& magnitudes{ current.buffers->magnitudes };
+    uint32_t analyzed{};
+    for (; pending; --pending, nextFrameEnd += hop) {
+        bool isAnalyzed{};
+        switch (current.config.analyzerType) {
+        case AnalyzerType::FFT:
+            isAnalyzed = AnalyzeFrame(current, nextFrameEnd);
+            break;
+        case AnalyzerType::GOERTZEL_BANK:
+            isAnalyzed = AnalyzeBankFrame(current, nextFrameEnd);
+            break;
+        default:
+            isAnalyzed = AnalyzeStreamFrame(current, nextFrameEnd);
+            break;
+        }
+        if (isAnalyzed) {
+            ++analyzed;
+            if (isPlotting)
+                PublishPeaks(current, nextFrameEnd);
+            if (onFrame) {
+                if constexpr (std::is_same_v<T, float>) {
+                    onFrame(nextFrameEnd, magnitudes);
+                }
+                else {
+                    for (uint32_t channel{}; channel < channelCount; ++channel)
+                        frameMagnitudes[channel].assign(magnitudes[channel].begin(), magnitudes[channel].end());
+                    onFrame(nextFrameEnd, frameMagnitudes);
+                }
+            }
+        }
+        else {
+            ++framesDropped;
+        }
+    }
+    framesAnalyzed += analyzed;
+
+    return analyzed;
+}
+
+template <typename T>
+void SpectrumEngineImpl<T>::Start()
+{
+    if (isRunning.exchange(true))
+        return;
+    workerThread = std::thread{ Worker, this };
+}
+
+template <typename T>
+void SpectrumEngineImpl<T>::Stop()
+{
+    {
+        // Under the worker's mutex, so it cannot miss the notify between testing its
+        // predicate and blocking
+        std::lock_guard lock{ sampleAvailMutex };
+        if (!isRunning.exchange(false))
+            return;
+    }
+    sampleAvailCond.notify_all();
+    workerThread.join();
+}
+
+template <typename T>
+void SpectrumEngineImpl<T>::Worker(SpectrumEngineImpl* engine)
+{
+    const auto& ring{ engine->sampleRing };
+
+    while (engine->isRunning) {
+        {
+            std::unique_lock lock{ engine->sampleAvailMutex };
+            engine->wakeSequence.store(engine->nextFrameEnd, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            engine->sampleAvailCond.wait(lock, [&] {
+                return !engine->isRunning || ring.WriteSequence() >= engine->nextFrameEnd;
+            });
+            engine->wakeSequence.store(NO_WAKEUP, std::memory_order_relaxed);
+        }
+        engine->Process();
+    }
+}
+
+template <typename T>
+bool SpectrumEngineImpl<T>::AnalyzeFrame(const AnalysisState& state, uint64_t frameEnd)
+{
+    const uint32_t frameSize{ state.config.fftSize };
+    const uint64_t frameBegin{ frameEnd - frameSize };
+    const T* window{ state.windows[0]->data() };
+    auto& jobs{ state.buffers->jobs };
+    auto& magnitudes{ state.buffers->magnitudes };
+    std::atomic_bool isIntact{ true };
+
+    workerPool.ParallelFor(static_cast<uint32_t>(jobs.size()), [&](uint32_t index) {
+        auto& job{ jobs[index] };
+        const uint32_t channel{ job.channel };
+
+        if (job.isPacked) {
+            ::ApplyWindowPacked<T>(sampleRing.Peek(channel, frameEnd, frameSize), 
+                                   sampleRing.Peek(channel + 1, frameEnd, frameSize), 
+                                   window, job.complexIn.data());
+        }
+        else {
+            ::ApplyWindow<T>(sampleRing.Peek(channel, frameEnd, frameSize), window, job.realIn.data());
+        }
+
+        // The producer lapped us while copying
+        if (!sampleRing.IsIntact(frameBegin)) {
+            isIntact = false;
+            return;
+        }
+
+        if (job.isPacked) {
+            job.complexFFT->forward(job.complexIn, job.out);
+            ::SplitPackedMagnitudes(job.out.data(), frameSize, magnitudes[channel].data(), magnitudes[channel + 1].data(), 
+                                    state.config.magnitudeMode);
+        }
+        else {
+            job.realFFT->forward(job.realIn, job.out);
+            ::ComputeMagnitudes(job.out.data(), magnitudes[channel].data(), state.resultSize, state.config.magnitudeMode);
+        }
+    });
+
+    if (!isIntact)
+        return false;
+
+    return true;
+}
+
+template <typename T>
+bool SpectrumEngineImpl<T>::AnalyzeStreamFrame(const AnalysisState& state, uint64_t frameEnd)
+{
+    auto& buffers{ *state.buffers };
+    auto& analyzers{ buffers.streamAnalyzers };
+
+    // Stream everything since the previous frame through the analyzers. On the first
+    // frame, or after a gap the ring no longer covers, start over from this frame's input.
+    uint64_t streamBegin{ buffers.streamEnd };
+    if (!streamBegin || streamBegin > frameEnd || frameEnd - streamBegin > sampleRing.Capacity() / 2) {
+        streamBegin = frameEnd - state.inputSize;
+        for (auto& analyzer : analyzers)
+            analyzer->Reset();
+    }
+    const uint32_t count{ static_cast<uint32_t>(frameEnd - streamBegin) };
+    std::atomic_bool isIntact{ true };
+
+    workerPool.ParallelFor(channelCount, [&](uint32_t channel) {
+        const auto [first, second] { sampleRing.Peek(channel, frameEnd, count) };
+        analyzers[channel]->Push(first.data, first.size);
+        analyzers[channel]->Push(second.data, second.size);
+    });
+
+    // The producer lapped us while copying; the history is torn, so start over next time
+    if (!sampleRing.IsIntact(streamBegin)) {
+        buffers.streamEnd = 0;
+        return false;
+    }
+    buffers.streamEnd = frameEnd;
+
+    const uint32_t taskCount{ analyzers[0]->GetTaskCount() };
+    workerPool.ParallelFor(channelCount * taskCount, [&](uint32_t index) {
+        const uint32_t channel{ index / taskCount };
+        const uint32_t task{ index % taskCount };
+        analyzers[channel]->Analyze(task, state.windows[task], state.hopSize, state.config.magnitudeMode, 
+                                    buffers.magnitudes[channel].data());
+    });
+
+    return true;
+}
+
+template <typename T>
+bool SpectrumEngineImpl<T>::AnalyzeBankFrame(const AnalysisState& state, uint64_t frameEnd)
+{
+    const uint32_t frameSize{ state.inputSize };
+    const uint64_t frameBegin{ frameEnd - frameSize };
+    const T* window{ state.windows[0]->data() };
+    auto& buffers{ *state.buffers };
+    std::atomic_bool isIntact{ true };
+
+    workerPool.ParallelFor(channelCount, [&](uint32_t channel) {
+        T* windowed{ buffers.windowed[channel].data() };
+        ::ApplyWindow<T>(sampleRing.Peek(channel, frameEnd, frameSize), window, windowed);
+
+        // The producer lapped us while copying
+        if (!sampleRing.IsIntact(frameBegin)) {
+            isIntact = false;
+            return;
+        }
+        buffers.goertzelBank->Process(windowed, frameSize, state.config.magnitudeMode, buffers.magnitudes[channel].data());
+    });
+
+    if (!isIntact)
+        return false;
+
+    return true;
+}
+
+template <typename T>
+void SpectrumEngineImpl<T>::PublishPeaks(const AnalysisState& state, uint64_t frameEnd)
+{
+    const auto& magnitudes{ state.buffers->magnitudes };
+
+    // Closed form, so the fall only depends on the input time since the previous frame
+    const T elapsed{ static_cast<T>(frameEnd - lastFrameEnd) / sampleRate };
+    const T decay{ std::exp(-FALL_RATE * state.config.fallSpeed * elapsed) };
+
+    Frame& back{ plotFrames[plotBack] };
+    back.sequence = frameEnd;
+    back.positions = *state.plotPositions;
+    back.heights.resize(channelCount);
+    for (uint32_t channel{}; channel < channelCount; ++channel) {
+        ::UpdatePeaks(magnitudes[channel].data(), heights[channel].data(), state.resultSize, decay);
+
+        // Reduced and mapped here so the render thread only copies what it plots
+        auto& plot{ back.heights[channel] };
+        if (state.decimator) {
+            plot.resize(state.decimator->GetSize());
+            state.decimator->Decimate(heights[channel].data(), plot.data());
+            state.scale->MapHeights(plot.data(), plot.data(), state.decimator->GetSize());
+        }
+        else {
+            plot.resize(state.resultSize);
+            state.scale->MapHeights(heights[channel].data(), plot.data(), state.resultSize);
+        }
+    }
+    lastFrameEnd = frameEnd;
+
+    if (state.decimator) {
+        const T* channels[MAX_CHANNEL_COUNT]{};
+        for (uint32_t channel{}; channel < channelCount; ++channel)
+            channels[channel] = heights[channel].data();
+        back.levels.resize(state.decimator->GetColumnCount());
+        state.decimator->Quantize(channels, channelCount, *state.scale, back.levels.data());
+    }
+    else {
+        back.levels.clear();
+    }
+
+    if (onPlot)
+        onPlot(back);
+    plotBack = plotMiddle.exchange(plotBack | FRESH_FRAME) & ~FRESH_FRAME;
+}
+
+template <typename T>
+bool SpectrumEngineImpl<T>::PullFrame(Frame& frame)
+{
+    if (plotMiddle.load() & FRESH_FRAME)
+        plotFront = plotMiddle.exchange(plotFront) & ~FRESH_FRAME;
+
+    const Frame& newest{ plotFrames[plotFront] };
+    const bool isNew{ frame.sequence != newest.sequence };
+    frame = newest;
+    return isNew;
+}
+
+template <typename T>
+void SpectrumEngineImpl<T>::SetPlotCallback(PlotCallback onPlot)
+{
+    assert(!isRunning);
+    this->onPlot = std::move(onPlot);
+}
+
+template <typename T>
+void SpectrumEngineImpl<T>::Reset(uint32_t fftSize)
+{
+    assert(fftSize >= 128 && fftSize <= MAX_FFT_SIZE);
+
+    this->fftSize = fftSize;
+    UpdateSizes();
+    RequestState();
+}
+
+template <typename T>
+void SpectrumEngineImpl<T>::SetWindow(WindowType windowType, float windowParameter)
+{
+    this->windowType = windowType;
+    this->windowParameter = windowParameter ? windowParameter : GetDefaultWindowParameter(windowType);
+    RequestState();
+}
+
+template <typename T>
+void SpectrumEngineImpl<T>::SetOverlap(float overlap)
+{
+    assert(overlap >= 0 && overlap < 1);
+
+    this->overlap = overlap;
+    UpdateSizes();
+    RequestState();
+}
+
+template <typename T>
+void SpectrumEngineImpl<T>::SetStereoPacking(bool stereoPacking)
+{
+    this->stereoPacking = stereoPacking;
+    RequestState();
+}
+
+template <typename T>
+void SpectrumEngineImpl<T>::SetMagnitudeMode(MagnitudeMode magnitudeMode)
+{
+    this->magnitudeMode = magnitudeMode;
+    RequestState();
+}
+
+template <typename T>
+void SpectrumEngineImpl<T>::SetAnalyzer(AnalyzerType analyzerType, uint32_t binsPerOctave)
+{
+    assert(binsPerOctave);
+
+    this->analyzerType = analyzerType;
+    this->binsPerOctave = binsPerOctave;
+    UpdateSizes();
+    RequestState();
+}
+
+template <typename T>
+void SpectrumEngineImpl<T>::SetTargetFrequencies(const std::vector<float>& targetFrequencies)
+{
+    UpdateTargets(targetFrequencies);
+    UpdateSizes();
+    RequestState();
+}
+
+template <typename T>
+void SpectrumEngineImpl<T>::SetPlotColumns(uint32_t plotColumns)
+{
+    this->plotColumns = plotColumns;
+    RequestState();
+}
+
+template <typename T>
+void SpectrumEngineImpl<T>::SetScaleType(ScaleType scaleType)
+{
+    this->scaleType = scaleType;
+    RequestState();
+}
+
+template <typename T>
+void SpectrumEngineImpl<T>::SetFallSpeed(float fallSpeed)
+{
+    assert(fallSpeed >= 0);
+
+    this->fallSpeed = fallSpeed;
+    RequestState();
+}
+
+template <typename T>
+void SpectrumEngineImpl<T>::ResetPeaks(const AnalysisState& state)
+{
+    peakFrequencies = state.frequencies;
+    for (uint32_t channel{}; channel < channelCount; ++channel)
+        heights[channel] = std::vector<T>(state.resultSize);
+}
+
+// Sorted, without duplicates and strictly between DC and Nyquist, so they plot as a spectrum
+template <typename T>
+void SpectrumEngineImpl<T>::UpdateTargets(const std::vector<float>& requested)
+{
+    const auto isOutOfRange = [&](float f) { return f <= 0 || f >= sampleRate / 2.f; };
+    targetFrequencies = requested;
+    std::sort(targetFrequencies.begin(), targetFrequencies.end());
+    targetFrequencies.erase(std::unique(targetFrequencies.begin(), targetFrequencies.end()), targetFrequencies.end());
+    targetFrequencies.erase(std::remove_if(targetFrequencies.begin(), targetFrequencies.end(), isOutOfRange), targetFrequencies.end());
+
+    // Nothing left to analyze is treated like no request at all
+    if (targetFrequencies.empty()) {
+        targetFrequencies = GoertzelBank<T>::GetDefaultFrequencies();
+        targetFrequencies.erase(std::remove_if(targetFrequencies.begin(), targetFrequencies.end(), isOutOfRange), targetFrequencies.end());
+    }
+}
+
+// Keeps the getters in line with the requested configuration
+template <typename T>
+void SpectrumEngineImpl<T>::UpdateSizes()
+{
+    const AnalysisConfig config{ GetConfig() };
+    frequencies = GetLayoutFrequencies(config);
+    hopSize = ComputeHopSize(config);
+    fftResultSize = static_cast<uint32_t>(frequencies.size());
+}
+
+template <typename T>
+uint32_t SpectrumEngineImpl<T>::GetInputSize(const AnalysisConfig& config) const
+{
+    switch (config.analyzerType) {
+    case AnalyzerType::LOG_FREQUENCY:
+        return LogAnalyzer<T>::GetFFTSize(config.binsPerOctave);
+    case AnalyzerType::MULTI_RESOLUTION:
+        return MultiResolutionAnalyzer<T>::GetInputSize(config.fftSize);
+    case AnalyzerType::GOERTZEL_BANK:
+        return GoertzelBank<T>::GetBlockSize(sampleRate, config.targetFrequencies);
+    default:
+        return config.fftSize;
+    }
+}
+
+template <typename T>
+uint32_t SpectrumEngineImpl<T>::ComputeHopSize(const AnalysisConfig& config) const
+{
+    const uint32_t base{ config.analyzerType == AnalyzerType::SLIDING_DFT ? SlidingDFT<T>::HOP_SIZE_BASE : GetInputSize(config) };
+    return std::max(1u, static_cast<uint32_t>(base * (1 - config.overlap)));
+}
+
+template <typename T>
+std::vector<float> SpectrumEngineImpl<T>::GetLayoutFrequencies(const AnalysisConfig& config) const
+{
+    switch (config.analyzerType) {
+    case AnalyzerType::LOG_FREQUENCY:
+        return LogAnalyzer<T>::GetFrequencies(sampleRate, config.binsPerOctave);
+    case AnalyzerType::MULTI_RESOLUTION:
+        return MultiResolutionAnalyzer<T>::GetFrequencies(sampleRate, config.fftSize);
+    case AnalyzerType::SLIDING_DFT:
+        return SlidingDFT<T>::GetFrequencies(sampleRate, config.fftSize, config.binsPerOctave);
+    case AnalyzerType::GOERTZEL_BANK:
+        return config.targetFrequencies;
+    default: {
+        std::vector<float> frequencies(config.fftSize / 2);
+        for (uint32_t i{}; i < frequencies.size(); ++i)
+            frequencies[i] = static_cast<float>(i) * sampleRate / config.fftSize;
+        return frequencies;
+    }
+    }
+}
+
+template <typename T>
+typename SpectrumEngineImpl<T>::AnalysisConfig SpectrumEngineImpl<T>::GetConfig() const
+{
+    return { fftSize, overlap, windowType, windowParameter, magnitudeMode, stereoPacking, analyzerType, binsPerOctave, 
+             targetFrequencies, plotColumns, scaleType, fallSpeed };
+}
+
+template <typename T>
+void SpectrumEngineImpl<T>::RequestState()
+{
+    {
+        std::lock_guard lock{ builderMutex };
+        pendingConfig = GetConfig();
+    }
+    builderCond.notify_one();
+}
+
+template <typename T>
+void SpectrumEngineImpl<T>::Builder(SpectrumEngineImpl* engine)
+{
+    // How often retired states are checked for while the analyzer still holds one
+    static constexpr std::chrono::milliseconds RECLAIM_INTERVAL{ 50 };
+
+    std::unique_lock lock{ engine->builderMutex };
+    while (engine->isBuilderRunning) {
+        const auto isPending = [&] { return !engine->isBuilderRunning || engine->pendingConfig; };
+        if (engine->stateReclaimer.HasRetired())
+            engine->builderCond.wait_for(lock, RECLAIM_INTERVAL, isPending);
+        else
+            engine->builderCond.wait(lock, isPending);
+
+        // Requests that arrived while building collapse into the newest one
+        if (engine->pendingConfig && engine->isBuilderRunning) {
+            const AnalysisConfig config{ *engine->pendingConfig };
+            engine->pendingConfig.reset();
+            lock.unlock();
+
+            // Only this thread replaces the state, so the current one cannot go away here
+            auto next{ engine->CreateState(config, engine->state.load()) };
+            engine->stateReclaimer.Retire(std::unique_ptr<AnalysisState>{ engine->state.exchange(next.release()) });
+            { std::lock_guard sampleLock{ engine->sampleAvailMutex }; }
+            engine->sampleAvailCond.notify_all();
+
+            lock.lock();
+        }
+        engine->stateReclaimer.Collect();
+    }
+}
+
+template <typename T>
+std::unique_ptr<typename SpectrumEngineImpl<T>::AnalysisState> 
+SpectrumEngineImpl<T>::CreateState(const AnalysisConfig& config, const AnalysisState* previous) const
+{
+    auto next{ std::make_unique<AnalysisState>() };
+    next->generation = previous ? previous->generation + 1 : 1;
+    next->config = config;
+    next->inputSize = GetInputSize(config);
+    next->hopSize = ComputeHopSize(config);
+    if (config.analyzerType == AnalyzerType::MULTI_RESOLUTION) {
+        for (const auto& band : MultiResolutionAnalyzer<T>::GetBands(config.fftSize))
+            next->windows.push_back(::GetWindow<T>(config.windowType, band.fftSize, config.windowParameter));
+    }
+    else {
+        next->windows.push_back(::GetWindow<T>(config.windowType, next->inputSize, config.windowParameter));
+    }
+
+    // Plans and history only depend on the layout; everything else reuses them
+    const auto& p{ previous ? previous->config : AnalysisConfig{} };
+    bool isSameLayout{ previous && p.analyzerType == config.analyzerType };
+    switch (config.analyzerType) {
+    case AnalyzerType::LOG_FREQUENCY:
+        isSameLayout = isSameLayout && p.binsPerOctave == config.binsPerOctave;
+        break;
+    case AnalyzerType::MULTI_RESOLUTION:
+        isSameLayout = isSameLayout && p.fftSize == config.fftSize;
+        break;
+    case AnalyzerType::SLIDING_DFT:
+        isSameLayout = isSameLayout && p.fftSize == config.fftSize && p.binsPerOctave == config.binsPerOctave;
+        break;
+    case AnalyzerType::GOERTZEL_BANK:
+        isSameLayout = isSameLayout && p.targetFrequencies == config.targetFrequencies;
+        break;
+    default:
+        isSameLayout = isSameLayout && p.fftSize == config.fftSize && p.stereoPacking == config.stereoPacking;
+        break;
+    }
+    if (isSameLayout) {
+        next->buffers = previous->buffers;
+        next->frequencies = previous->frequencies;
+    }
+    else {
+        next->buffers = CreateBuffers(config);
+        next->frequencies = std::make_shared<const std::vector<float>>(GetLayoutFrequencies(config));
+    }
+    next->resultSize = static_cast<uint32_t>(next->frequencies->size());
+
+    if (isSameLayout && p.plotColumns == config.plotColumns && p.scaleType == config.scaleType &&
+        p.magnitudeMode == config.magnitudeMode) {
+        next->scale = previous->scale;
+        next->decimator = previous->decimator;
+        next->plotPositions = previous->plotPositions;
+        return next;
+    }
+
+    // The frequency axis runs from the lowest positive bin to Nyquist
+    const auto& bins{ *next->frequencies };
+    const auto lowest{ std::upper_bound(bins.begin(), bins.end(), 0.f) };
+    const float nyquist{ sampleRate / 2.f };
+    next->scale = std::make_shared<const PlotScale>(config.scaleType, config.magnitudeMode,
+                                                    lowest != bins.end() && *lowest < nyquist ? *lowest : 1.f, nyquist,
+                                                    PLOT_MIN_HEIGHT, PLOT_MAX_HEIGHT);
+    auto positions{ next->scale->MapFrequencies(bins) };
+    if (config.plotColumns && bins.size() > 1) {
+        next->decimator = std::make_shared<const ColumnDecimator<T>>(positions, config.plotColumns);
+        positions = next->decimator->GetPositions();
+    }
+    next->plotPositions = std::make_shared<const std::vector<float>>(std::move(positions));
+    return next;
+}
+
+template <typename T>
+std::shared_ptr<typename SpectrumEngineImpl<T>::AnalysisBuffers> 
+SpectrumEngineImpl<T>::CreateBuffers(const AnalysisConfig& config) const
+{
+    auto buffers{ std::make_shared<AnalysisBuffers>() };
+    if (config.analyzerType == AnalyzerType::GOERTZEL_BANK) {
+        buffers->goertzelBank = std::make_unique<GoertzelBank<T>>(sampleRate, config.targetFrequencies);
+        buffers->windowed.resize(channelCount, FFTValueVector<T>(GetInputSize(config)));
+        buffers->magnitudes.assign(channelCount, std::vector<T>(buffers->goertzelBank->GetSize()));
+        return buffers;
+    }
+    if (config.analyzerType != AnalyzerType::FFT) {
+        for (uint32_t channel{}; channel < channelCount; ++channel) {
+            std::unique_ptr<StreamAnalyzer<T>> analyzer{};
+            if (config.analyzerType == AnalyzerType::LOG_FREQUENCY)
+                analyzer = std::make_unique<LogAnalyzer<T>>(sampleRate, config.binsPerOctave);
+            else if (config.analyzerType == AnalyzerType::MULTI_RESOLUTION)
+                analyzer = std::make_unique<MultiResolutionAnalyzer<T>>(config.fftSize);
+            else
+                analyzer = std::make_unique<SlidingDFT<T>>(sampleRate, config.fftSize, config.binsPerOctave);
+            buffers->streamAnalyzers.push_back(std::move(analyzer));
+        }
+        buffers->magnitudes.assign(channelCount, std::vector<T>(buffers->streamAnalyzers[0]->GetResultSize()));
+        return buffers;
+    }
+
+    const int size{ static_cast<int>(config.fftSize) };
+    for (uint32_t channel{}; channel < channelCount;) {
+        AnalysisJob job{};
+        job.channel = channel;
+        job.isPacked = config.stereoPacking && channel + 1 < channelCount;
+        if (job.isPacked) {
+            job.complexFFT = std::make_unique<ComplexFFTInstance<T>>(size);
+            job.complexIn = job.complexFFT->valueVector();
+            job.out = job.complexFFT->spectrumVector();
+        }
+        else {
+            job.realFFT = std::make_unique<FFTInstance<T>>(size);
+            job.realIn = job.realFFT->valueVector();
+            job.out = job.realFFT->spectrumVector();
+        }
+        channel += job.isPacked ? 2 : 1;
+        buffers->jobs.push_back(std::move(job));
+    }
+    buffers->magnitudes.assign(channelCount, std::vector<T>(config.fftSize / 2));
+    return buffers;
+}
+
+template class SpectrumEngineImpl<float>;
+template class SpectrumEngineImpl<double>;
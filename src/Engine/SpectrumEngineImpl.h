@@ -0,0 +1,166 @@
+#pragma once
+
+#include "SpectrumEngine.h"
+#include "RingBuffer.h"
+#include "WorkerPool.h"
+#include "EpochReclaimer.h"
+#include "StreamAnalyzer.h"
+#include "GoertzelBank.h"
+#include "ColumnDecimator.h"
+
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <optional>
+
+// The pipeline in one precision; instantiated for float and double in SpectrumEngineImpl.cpp.
+template <typename T>
+class SpectrumEngineImpl final : public SpectrumEngine
+{
+public:
+    explicit SpectrumEngineImpl(const Settings& settings);
+    ~SpectrumEngineImpl() override;
+
+    void PushSamples(const float* samples, uint32_t frameCount) override;
+
+    uint32_t Process(const FrameCallback& onFrame = {}, bool isPlotting = true) override;
+    void Start() override;
+    void Stop() override;
+
+    bool PullFrame(Frame& frame) override;
+    void SetPlotCallback(PlotCallback onPlot) override;
+
+    void Reset(uint32_t fftSize) override;
+    void SetWindow(WindowType windowType, float windowParameter = 0) override;
+    void SetOverlap(float overlap) override;
+    void SetStereoPacking(bool stereoPacking) override;
+    void SetMagnitudeMode(MagnitudeMode magnitudeMode) override;
+    void SetAnalyzer(AnalyzerType analyzerType, uint32_t binsPerOctave = DEFAULT_BINS_PER_OCTAVE) override;
+    void SetTargetFrequencies(const std::vector<float>& targetFrequencies) override;
+    void SetPlotColumns(uint32_t plotColumns) override;
+    void SetScaleType(ScaleType scaleType) override;
+    void SetFallSpeed(float fallSpeed) override;
+
+private:
+    // One parallel task: a real FFT over a single channel, or a complex FFT over
+    // a packed pair. FFT plans keep internal scratch, so every job gets its own.
+    struct AnalysisJob {
+        uint32_t                               channel{};
+        bool                                   isPacked{};
+        std::unique_ptr<FFTInstance<T>>        realFFT{};
+        std::unique_ptr<ComplexFFTInstance<T>> complexFFT{};
+        FFTValueVector<T>                      realIn{};
+        FFTSpectrumVector<T>                   complexIn{};
+        FFTSpectrumVector<T>                   out{};
+    };
+
+    // FFT plans, analyzer history and scratch for one layout (analyzer, FFT size,
+    // packing, bins per octave), shared by successive states that only differ in
+    // cheaper settings.
+    struct AnalysisBuffers {
+        std::vector<AnalysisJob>                        jobs{};
+        std::vector<std::unique_ptr<StreamAnalyzer<T>>> streamAnalyzers{};  // One per channel
+        std::unique_ptr<GoertzelBank<T>>                goertzelBank{};     // Shared by all channels
+        std::vector<FFTValueVector<T>>                  windowed{};         // Bank input, one per channel
+        std::vector<std::vector<T>>                     magnitudes{};
+        // Input the stream analyzers have been fed up to
+        uint64_t                                        streamEnd{};
+    };
+
+    struct AnalysisConfig {
+        uint32_t      fftSize{};
+        float         overlap{};
+        WindowType    windowType{};
+        float         windowParameter{};
+        MagnitudeMode magnitudeMode{};
+        bool          stereoPacking{};
+        AnalyzerType  analyzerType{};
+        uint32_t      binsPerOctave{};
+        std::vector<float> targetFrequencies{};
+        uint32_t      plotColumns{};
+        ScaleType     scaleType{};
+        float         fallSpeed{};
+    };
+
+    // Everything a frame is analyzed with. Immutable once published; only the
+    // scratch behind `buffers` is written, and only by the thread in Process().
+    struct AnalysisState {
+        uint64_t                                  generation{};
+        AnalysisConfig                            config{};
+        uint32_t                                  inputSize{};   // Samples read per frame
+        uint32_t                                  resultSize{};
+        uint32_t                                  hopSize{};
+        std::shared_ptr<const std::vector<float>> frequencies{};
+        // The FFT's window, or one per analysis task of a stream analyzer
+        std::vector<std::shared_ptr<const FFTValueVector<T>>> windows{};
+        std::shared_ptr<AnalysisBuffers>          buffers{};
+        // What PullFrame() hands out: the bins as they are, or their plot columns' envelope,
+        // at positions mapped once per layout and scale
+        std::shared_ptr<const PlotScale>          scale{};
+        std::shared_ptr<const ColumnDecimator<T>> decimator{};
+        std::shared_ptr<const std::vector<float>> plotPositions{};
+    };
+
+private:
+    static void Worker(SpectrumEngineImpl* engine);
+    static void Builder(SpectrumEngineImpl* engine);
+    bool AnalyzeFrame(const AnalysisState& state, uint64_t frameEnd);
+    bool AnalyzeStreamFrame(const AnalysisState& state, uint64_t frameEnd);
+    bool AnalyzeBankFrame(const AnalysisState& state, uint64_t frameEnd);
+    void PublishPeaks(const AnalysisState& state, uint64_t frameEnd);
+    void ResetPeaks(const AnalysisState& state);
+    void UpdateSizes();
+    void UpdateTargets(const std::vector<float>& requested);
+
+    uint32_t GetInputSize(const AnalysisConfig& config) const;
+    uint32_t ComputeHopSize(const AnalysisConfig& config) const;
+    std::vector<float> GetLayoutFrequencies(const AnalysisConfig& config) const;
+    AnalysisConfig GetConfig() const;
+    void RequestState();
+    std::unique_ptr<AnalysisState> CreateState(const AnalysisConfig& config, const AnalysisState* previous) const;
+    std::shared_ptr<AnalysisBuffers> CreateBuffers(const AnalysisConfig& config) const;
+
+private:
+    uint64_t nextFrameEnd{};
+    uint64_t lastFrameEnd{};
+    uint64_t stateGeneration{};
+
+    // Published by the builder thread, read by whoever runs Process()
+    std::atomic<AnalysisState*>   state{};
+    EpochReclaimer<AnalysisState> stateReclaimer{};
+
+    std::shared_ptr<const std::vector<float>> peakFrequencies{};
+    std::vector<std::vector<T>>               heights{};
+    std::vector<std::vector<float>>           frameMagnitudes{};
+    PlotCallback                              onPlot{};
+
+    // Frames for PullFrame(), passed on by swapping indices: the analyzing thread fills
+    // the back frame and swaps it into the middle, the reader swaps a fresh middle frame
+    // for its front one. Neither side ever waits for the other.
+    static constexpr uint32_t FRESH_FRAME{ 1u << 31 };
+    Frame                 plotFrames[3]{};
+    uint32_t              plotBack{ 0 };
+    std::atomic<uint32_t> plotMiddle{ 1 };
+    uint32_t              plotFront{ 2 };
+
+    RingBuffer<T> sampleRing;
+    WorkerPool    workerPool;
+
+    std::mutex fftBusyMutex{};
+
+    std::mutex sampleAvailMutex{};
+    std::condition_variable sampleAvailCond{};
+    // Written samples the waiting worker needs before it can analyze, for PushSamples()
+    static constexpr uint64_t NO_WAKEUP{ UINT64_MAX };
+    std::atomic<uint64_t>     wakeSequence{ NO_WAKEUP };
+
+    std::thread workerThread{};
+    std::atomic_bool isRunning{};
+
+    // Latest requested configuration, built into a state off the calling thread
+    std::mutex                    builderMutex{};
+    std::condition_variable       builderCond{};
+    std::optional<AnalysisConfig> pendingConfig{};
+    bool                          isBuilderRunning{ true };
+    std::thread                   builderThread{};
+};
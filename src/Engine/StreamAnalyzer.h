@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Config.h"
+#include "Magnitude.h"
+
+#include <cstdint>
+#include <memory>
+
+// Analysis of one channel that keeps its own history of the input instead of reading
+// whole frames from the sample ring, e.g. to run decimators over it.
+template <typename T>
+class StreamAnalyzer
+{
+public:
+    virtual ~StreamAnalyzer() = default;
+
+    virtual uint32_t GetResultSize() const = 0;
+
+    // Drops all history, e.g. after a gap in the input.
+    virtual void Reset() = 0;
+
+    // Feeds consecutive input samples.
+    virtual void Push(const T* samples, uint32_t count) = 0;
+
+    // Analysis is split into GetTaskCount() parts that write disjoint parts of `dst`
+    // and may run concurrently after Push(). Task i is analyzed with the i-th window
+    // of the analyzer's layout, which the analyzer may hold on to for derived tables.
+    using Window = std::shared_ptr<const FFTValueVector<T>>;
+    virtual uint32_t GetTaskCount() const { return 1; }
+    virtual void Analyze(uint32_t task, const Window& window, uint32_t hopSize, MagnitudeMode mode, T* dst) = 0;
+};
@@ -0,0 +1,117 @@
+#include "WindowMultiply.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#if defined(SP_SIMD_AVX2) || defined(SP_SIMD_SSE2)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+template <typename T>
+void MultiplyScalar(const T* src, const T* window, T* dst, uint32_t begin, uint32_t end)
+{
+    for (uint32_t i{ begin }; i < end; ++i)
+        dst[i] = src[i] * window[i];
+}
+
+#if defined(SP_SIMD_AVX2)
+static constexpr uintptr_t VECTOR_ALIGNMENT{ 32 };
+
+inline uint32_t MultiplyBlocks(const float* src, const float* window, float* dst, uint32_t i, uint32_t count)
+{
+    for (; i + 8 <= count; i += 8)
+        _mm256_store_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(src + i), _mm256_load_ps(window + i)));
+    return i;
+}
+
+inline uint32_t MultiplyBlocks(const double* src, const double* window, double* dst, uint32_t i, uint32_t count)
+{
+    for (; i + 4 <= count; i += 4)
+        _mm256_store_pd(dst + i, _mm256_mul_pd(_mm256_loadu_pd(src + i), _mm256_load_pd(window + i)));
+    return i;
+}
+
+inline uint32_t MultiplyBlocksUnaligned(const float* src, const float* window, float* dst, uint32_t count)
+{
+    uint32_t i{};
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(src + i), _mm256_loadu_ps(window + i)));
+    return i;
+}
+
+inline uint32_t MultiplyBlocksUnaligned(const double* src, const double* window, double* dst, uint32_t count)
+{
+    uint32_t i{};
+    for (; i + 4 <= count; i += 4)
+        _mm256_storeu_pd(dst + i, _mm256_mul_pd(_mm256_loadu_pd(src + i), _mm256_loadu_pd(window + i)));
+    return i;
+}
+#elif defined(SP_SIMD_SSE2)
+static constexpr uintptr_t VECTOR_ALIGNMENT{ 16 };
+
+inline uint32_t MultiplyBlocks(const float* src, const float* window, float* dst, uint32_t i, uint32_t count)
+{
+    for (; i + 4 <= count; i += 4)
+        _mm_store_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(src + i), _mm_load_ps(window + i)));
+    return i;
+}
+
+inline uint32_t MultiplyBlocks(const double* src, const double* window, double* dst, uint32_t i, uint32_t count)
+{
+    for (; i + 2 <= count; i += 2)
+        _mm_store_pd(dst + i, _mm_mul_pd(_mm_loadu_pd(src + i), _mm_load_pd(window + i)));
+    return i;
+}
+
+inline uint32_t MultiplyBlocksUnaligned(const float* src, const float* window, float* dst, uint32_t count)
+{
+    uint32_t i{};
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(src + i), _mm_loadu_ps(window + i)));
+    return i;
+}
+
+inline uint32_t MultiplyBlocksUnaligned(const double* src, const double* window, double* dst, uint32_t count)
+{
+    uint32_t i{};
+    for (; i + 2 <= count; i += 2)
+        _mm_storeu_pd(dst + i, _mm_mul_pd(_mm_loadu_pd(src + i), _mm_loadu_pd(window + i)));
+    return i;
+}
+#endif
+
+template <typename T>
+void MultiplyWindowImpl(const T* src, const T* window, T* dst, uint32_t count)
+{
+    uint32_t done{};
+#if defined(SP_SIMD_AVX2) || defined(SP_SIMD_SSE2)
+    const auto windowAddress{ reinterpret_cast<uintptr_t>(window) };
+    const auto dstAddress{ reinterpret_cast<uintptr_t>(dst) };
+    if ((windowAddress - dstAddress) % VECTOR_ALIGNMENT == 0 && dstAddress % sizeof(T) == 0) {
+        // Peel until dst (and with it the window) sits on a vector boundary.
+        // The ring's read position is arbitrary, so src stays unaligned
+        const auto misalignment{ dstAddress % VECTOR_ALIGNMENT };
+        const uint32_t head{ std::min(count, static_cast<uint32_t>(misalignment ? (VECTOR_ALIGNMENT - misalignment) / sizeof(T) : 0)) };
+        MultiplyScalar(src, window, dst, 0, head);
+        done = MultiplyBlocks(src, window, dst, head, count);
+    }
+    else {
+        done = MultiplyBlocksUnaligned(src, window, dst, count);
+    }
+#endif
+    MultiplyScalar(src, window, dst, done, count);
+}
+
+}
+
+void MultiplyWindow(const float* src, const float* window, float* dst, uint32_t count)
+{
+    MultiplyWindowImpl(src, window, dst, count);
+}
+
+void MultiplyWindow(const double* src, const double* window, double* dst, uint32_t count)
+{
+    MultiplyWindowImpl(src, window, dst, count);
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "Config.h"
+
+// dst[i] = src[i] * window[i] for `count` samples. The SIMD path uses aligned
+// window loads and dst stores once dst is on a vector boundary, so pass
+// buffers that share their alignment (e.g. both from pffft's AlignedVector).
+void MultiplyWindow(const float* src, const float* window, float* dst, uint32_t count);
+void MultiplyWindow(const double* src, const double* window, double* dst, uint32_t count);
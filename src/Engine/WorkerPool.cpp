@@ -0,0 +1,64 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(uint32_t threadCount)
+{
+    for (uint32_t i{}; i < threadCount; ++i)
+        threads.emplace_back(Worker, this);
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard lock{ mutex };
+        isRunning = false;
+    }
+    wakeCond.notify_all();
+    for (auto& thread : threads)
+        thread.join();
+}
+
+void WorkerPool::Run(uint32_t count, TaskFunc func, void* context)
+{
+    {
+        std::lock_guard lock{ mutex };
+        taskFunc = func;
+        taskContext = context;
+        taskCount = count;
+        nextTask = 0;
+        activeWorkers = static_cast<uint32_t>(threads.size());
+        ++generation;
+    }
+    wakeCond.notify_all();
+
+    RunTasks();
+
+    std::unique_lock lock{ mutex };
+    doneCond.wait(lock, [this] { return !activeWorkers; });
+}
+
+void WorkerPool::RunTasks()
+{
+    for (uint32_t i{ nextTask++ }; i < taskCount; i = nextTask++)
+        taskFunc(taskContext, i);
+}
+
+void WorkerPool::Worker(WorkerPool* pool)
+{
+    uint64_t seenGeneration{};
+
+    for (;;) {
+        {
+            std::unique_lock lock{ pool->mutex };
+            pool->wakeCond.wait(lock, [&] { return !pool->isRunning || pool->generation != seenGeneration; });
+            if (!pool->isRunning)
+                return;
+            seenGeneration = pool->generation;
+        }
+
+        pool->RunTasks();
+
+        std::lock_guard lock{ pool->mutex };
+        if (!--pool->activeWorkers)
+            pool->doneCond.notify_one();
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+
+// Fixed set of threads that run index-parallel jobs. The calling thread
+// takes part in every job, so a pool of N threads runs N + 1 tasks at once.
+class WorkerPool
+{
+public:
+    explicit WorkerPool(uint32_t threadCount);
+    ~WorkerPool();
+
+    uint32_t GetThreadCount() const { return static_cast<uint32_t>(threads.size()); }
+
+    // Runs task(i) for every i in [0, count) and returns once all of them finished.
+    template <typename F>
+    void ParallelFor(uint32_t count, F&& task)
+    {
+        if (threads.empty() || count < 2) {
+            for (uint32_t i{}; i < count; ++i)
+                task(i);
+            return;
+        }
+        Run(count, [](void* context, uint32_t i) { (*static_cast<F*>(context))(i); }, &task);
+    }
+
+private:
+    using TaskFunc = void(*)(void* context, uint32_t index);
+
+    void Run(uint32_t count, TaskFunc func, void* context);
+    void RunTasks();
+    static void Worker(WorkerPool* pool);
+
+private:
+    std::vector<std::thread> threads{};
+
+    std::mutex mutex{};
+    std::condition_variable wakeCond{};
+    std::condition_variable doneCond{};
+
+    TaskFunc taskFunc{};
+    void*    taskContext{};
+    uint32_t taskCount{};
+    std::atomic<uint32_t> nextTask{};
+
+    uint64_t generation{};
+    uint32_t activeWorkers{};
+    bool     isRunning{ true };
+};
@@ -1,6 +0,0 @@
-#pragma once
-
-#include "Config.h"
-
-void GenBlackmanHarrisWindow(SP_FLOAT* dst, uint32_t size);
-
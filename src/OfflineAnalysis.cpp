@@ -0,0 +1,233 @@
+#include "OfflineAnalysis.h"
+#include "SpectrumEngine.h"
+
+#include <miniaudio.h>
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct OfflineOptions {
+    const char* inputPath{};
+    const char* outputPath{};
+    SpectrumEngine::Settings settings{};
+};
+
+WindowType ParseWindowType(const char* name)
+{
+    static constexpr std::pair<const char*, WindowType> windowTypes[] = {
+        { "blackman-harris", WindowType::BLACKMAN_HARRIS },
+        { "hann", WindowType::HANN },
+        { "hamming", WindowType::HAMMING },
+        { "nuttall", WindowType::NUTTALL },
+        { "flat-top", WindowType::FLAT_TOP },
+        { "kaiser", WindowType::KAISER },
+        { "gaussian", WindowType::GAUSSIAN }
+    };
+    for (const auto& [windowName, type] : windowTypes) {
+        if (!std::strcmp(name, windowName))
+            return type;
+    }
+    throw std::runtime_error{ std::string{ "Unknown window " } + name };
+}
+
+OfflineOptions ParseOptions(int argc, char** argv)
+{
+    OfflineOptions options{};
+    for (int i{ 2 }; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--fft-size") && i + 1 < argc) {
+            const uint32_t fftSize{ static_cast<uint32_t>(std::stoul(argv[++i])) };
+            if (fftSize < 128 || fftSize > MAX_FFT_SIZE || (fftSize & (fftSize - 1)))
+                throw std::runtime_error{ "FFT size must be a power of two in [128, 32768]" };
+            options.settings.fftSize = fftSize;
+        }
+        else if (!std::strcmp(argv[i], "--overlap") && i + 1 < argc) {
+            const float overlap{ static_cast<float>(std::stod(argv[++i]) / 100) };
+            if (overlap < 0 || overlap >= 1)
+                throw std::runtime_error{ "Overlap must be in [0, 100)" };
+            options.settings.overlap = overlap;
+        }
+        else if (!std::strcmp(argv[i], "--precision") && i + 1 < argc) {
+            const char* precision{ argv[++i] };
+            if (!std::strcmp(precision, "f32"))
+                options.settings.precision = SpectrumEngine::Precision::F32;
+            else if (!std::strcmp(precision, "f64"))
+                options.settings.precision = SpectrumEngine::Precision::F64;
+            else
+                throw std::runtime_error{ "Precision must be f32 or f64" };
+        }
+        else if (!std::strcmp(argv[i], "--magnitude") && i + 1 < argc) {
+            const char* mode{ argv[++i] };
+            if (!std::strcmp(mode, "exact"))
+                options.settings.magnitudeMode = SpectrumEngine::MagnitudeMode::EXACT;
+            else if (!std::strcmp(mode, "power"))
+                options.settings.magnitudeMode = SpectrumEngine::MagnitudeMode::POWER;
+            else if (!std::strcmp(mode, "fast"))
+                options.settings.magnitudeMode = SpectrumEngine::MagnitudeMode::FAST;
+            else
+                throw std::runtime_error{ "Magnitude must be exact, power or fast" };
+        }
+        else if (!std::strcmp(argv[i], "--analyzer") && i + 1 < argc) {
+            const char* analyzer{ argv[++i] };
+            if (!std::strcmp(analyzer, "fft"))
+                options.settings.analyzerType = SpectrumEngine::AnalyzerType::FFT;
+            else if (!std::strcmp(analyzer, "log"))
+                options.settings.analyzerType = SpectrumEngine::AnalyzerType::LOG_FREQUENCY;
+            else if (!std::strcmp(analyzer, "multi"))
+                options.settings.analyzerType = SpectrumEngine::AnalyzerType::MULTI_RESOLUTION;
+            else if (!std::strcmp(analyzer, "sliding"))
+                options.settings.analyzerType = SpectrumEngine::AnalyzerType::SLIDING_DFT;
+            else if (!std::strcmp(analyzer, "goertzel"))
+                options.settings.analyzerType = SpectrumEngine::AnalyzerType::GOERTZEL_BANK;
+            else
+                throw std::runtime_error{ "Analyzer must be fft, log, multi, sliding or goertzel" };
+        }
+        else if (!std::strcmp(argv[i], "--targets") && i + 1 < argc) {
+            std::stringstream list{ argv[++i] };
+            for (std::string item{}; std::getline(list, item, ',');) {
+                const float frequency{ std::stof(item) };
+                if (frequency <= 0)
+                    throw std::runtime_error{ "Target frequencies must be positive" };
+                options.settings.targetFrequencies.push_back(frequency);
+            }
+        }
+        else if (!std::strcmp(argv[i], "--bins-per-octave") && i + 1 < argc) {
+            const int bins{ std::stoi(argv[++i]) };
+            if (bins < 1 || bins > 192)
+                throw std::runtime_error{ "Bins per octave must be in [1, 192]" };
+            options.settings.binsPerOctave = static_cast<uint32_t>(bins);
+        }
+        else if (!std::strcmp(argv[i], "--window") && i + 1 < argc) {
+            options.settings.windowType = ParseWindowType(argv[++i]);
+        }
+        else if (!std::strcmp(argv[i], "--window-param") && i + 1 < argc) {
+            options.settings.windowParameter = std::stof(argv[++i]);
+            if (options.settings.windowParameter <= 0)
+                throw std::runtime_error{ "Window parameter must be positive" };
+        }
+        else if (!options.inputPath) {
+            options.inputPath = argv[i];
+        }
+        else if (!options.outputPath) {
+            options.outputPath = argv[i];
+        }
+        else {
+            throw std::runtime_error{ std::string{ "Unexpected argument " } + argv[i] };
+        }
+    }
+
+    if (!options.inputPath || !options.outputPath)
+        throw std::runtime_error{ "Usage: spectra --analyze <input> <output> [--fft-size N] [--overlap PERCENT] [--precision f32|f64]"
+                                   " [--magnitude exact|power|fast] [--window NAME] [--window-param X]"
+                                   " [--analyzer fft|log|multi|sliding|goertzel] [--bins-per-octave N] [--targets F1,F2,...]" };
+    return options;
+}
+
+void Analyze(const OfflineOptions& options)
+{
+    ma_decoder decoder{};
+    const auto decoderConfig{ ma_decoder_config_init(ma_format_f32, 0, 0) };
+    if (ma_decoder_init_file(options.inputPath, &decoderConfig, &decoder) != MA_SUCCESS)
+        throw std::runtime_error{ std::string{ "Could not decode " } + options.inputPath };
+
+    if (!decoder.outputChannels || decoder.outputChannels > MAX_CHANNEL_COUNT) {
+        ma_decoder_uninit(&decoder);
+        throw std::runtime_error{ "Unsupported channel count" };
+    }
+
+    auto settings{ options.settings };
+    settings.channelCount = decoder.outputChannels;
+    settings.sampleRate = decoder.outputSampleRate;
+
+    // Targets can only be checked against the sample rate once the input is open
+    const float nyquist{ settings.sampleRate / 2.f };
+    for (const float frequency : settings.targetFrequencies) {
+        if (frequency >= nyquist) {
+            ma_decoder_uninit(&decoder);
+            throw std::runtime_error{ "Target frequencies must be below half the sample rate (" +
+                                      std::to_string(settings.sampleRate) + " Hz)" };
+        }
+    }
+    const auto engine{ SpectrumEngine::Create(settings) };
+
+    std::ofstream out{ options.outputPath, std::ios::binary };
+    if (!out) {
+        ma_decoder_uninit(&decoder);
+        throw std::runtime_error{ std::string{ "Could not open " } + options.outputPath };
+    }
+
+    SpectrumFileHeader header{};
+    header.sampleRate = engine->GetSampleRate();
+    header.channelCount = engine->GetChannelCount();
+    header.fftSize = engine->GetFFTSize();
+    header.hopSize = engine->GetHopSize();
+    header.binCount = engine->GetResultSize();
+    header.valueSize = sizeof(float);
+    header.analyzerType = static_cast<uint32_t>(engine->GetAnalyzerType());
+    header.binsPerOctave = engine->GetBinsPerOctave();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(engine->GetFrequencies().data()), header.binCount * sizeof(float));
+
+    const auto writeFrame = [&](uint64_t frameEnd, const std::vector<std::vector<float>>& magnitudes) {
+        out.write(reinterpret_cast<const char*>(&frameEnd), sizeof(frameEnd));
+        for (const auto& m : magnitudes)
+            out.write(reinterpret_cast<const char*>(m.data()), m.size() * sizeof(float));
+        ++header.frameCount;
+    };
+
+    // Feed one hop at a time so the scheduler never has a reason to drop frames
+    const uint32_t chunkSize{ engine->GetHopSize() };
+    std::vector<float> chunk(chunkSize * engine->GetChannelCount());
+    uint64_t decodedFrames{};
+
+    const SP_TIMEPOINT startTime{ SP_TIME_NOW() };
+    for (;;) {
+        ma_uint64 framesRead{};
+        const ma_result result{ ma_decoder_read_pcm_frames(&decoder, chunk.data(), chunkSize, &framesRead) };
+        if (framesRead) {
+            engine->PushSamples(chunk.data(), static_cast<uint32_t>(framesRead));
+            engine->Process(writeFrame, false);
+            decodedFrames += framesRead;
+        }
+        if (result != MA_SUCCESS || framesRead < chunkSize)
+            break;
+    }
+    const double elapsed{ SP_TIME_DELTA(startTime) };
+    ma_decoder_uninit(&decoder);
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!out)
+        throw std::runtime_error{ std::string{ "Could not write " } + options.outputPath };
+
+    const double duration{ static_cast<double>(decodedFrames) / header.sampleRate };
+    std::cout << "Analyzed " << duration << " s of audio (" << header.frameCount << " frames) in "
+              << elapsed << " s, " << duration / std::max(elapsed, 1e-6) << "x real time\n";
+}
+
+}
+
+bool IsOfflineAnalysis(int argc, char** argv)
+{
+    return argc > 1 && !std::strcmp(argv[1], "--analyze");
+}
+
+int RunOfflineAnalysis(int argc, char** argv)
+{
+    try {
+        Analyze(ParseOptions(argc, argv));
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Config.h"
+
+#include <cstdint>
+
+// spectra --analyze <input> <output> [options], see README.md
+//
+// Decodes <input> and runs it through the analysis pipeline as fast as possible,
+// writing every frame's magnitudes to <output>:
+//
+//   SpectrumFileHeader
+//   float frequencies[binCount]
+//   frameCount x { uint64_t frameEnd; float magnitudes[channelCount][binCount]; }
+struct SpectrumFileHeader {
+    char     magic[4]{ 'S', 'P', 'E', 'C' };
+    uint32_t version{ 2 };
+    uint32_t sampleRate{};
+    uint32_t channelCount{};
+    uint32_t fftSize{};
+    uint32_t hopSize{};
+    uint32_t binCount{};
+    uint32_t valueSize{};
+    uint32_t analyzerType{};    // SpectrumEngine::AnalyzerType; fftSize is unused by LOG_FREQUENCY
+    uint32_t binsPerOctave{};   // LOG_FREQUENCY and SLIDING_DFT only
+    uint64_t frameCount{};
+};
+
+bool IsOfflineAnalysis(int argc, char** argv);
+int RunOfflineAnalysis(int argc, char** argv);
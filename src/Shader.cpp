@@ -0,0 +1,49 @@
+#include "Shader.h"
+
+#include <glad/glad.h>
+
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+GLuint CompileShader(GLenum type, const char* source)
+{
+    const GLuint shader{ glCreateShader(type) };
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    GLint isCompiled{};
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &isCompiled);
+    if (!isCompiled) {
+        char log[1024]{};
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        glDeleteShader(shader);
+        throw std::runtime_error{ std::string{ "Could not compile shader\n" } + log };
+    }
+    return shader;
+}
+
+}
+
+uint32_t CreateShaderProgram(const char* vertexSource, const char* fragmentSource)
+{
+    const GLuint vertexShader{ CompileShader(GL_VERTEX_SHADER, vertexSource) };
+    const GLuint fragmentShader{ CompileShader(GL_FRAGMENT_SHADER, fragmentSource) };
+    const GLuint program{ glCreateProgram() };
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    glLinkProgram(program);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    GLint isLinked{};
+    glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+    if (!isLinked) {
+        char log[1024]{};
+        glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+        glDeleteProgram(program);
+        throw std::runtime_error{ std::string{ "Could not link shader\n" } + log };
+    }
+    return program;
+}
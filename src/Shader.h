@@ -0,0 +1,7 @@
+#pragma once
+
+#include <cstdint>
+
+// Compiles and links a vertex and fragment shader into a program; throws with the
+// compiler's log on failure.
+uint32_t CreateShaderProgram(const char* vertexSource, const char* fragmentSource);
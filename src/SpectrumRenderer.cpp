@@ -0,0 +1,186 @@
+#include "SpectrumRenderer.h"
+#include "Shader.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+// Region layout: positions[MAX_POINTS], then heights[MAX_POINTS] for every channel, all 0..1
+static constexpr const char* VERTEX_SHADER{ R"(
+#version 460 core
+
+layout(std430, binding = 0) readonly buffer Points { float points[]; };
+
+layout(location = 0) uniform uint  pointCount;
+layout(location = 1) uniform uint  heightOffset;
+layout(location = 2) uniform vec2  viewportSize;
+layout(location = 3) uniform float lineWidth;
+layout(location = 4) uniform bool  isFill;
+
+// Normalized device coordinates of a point
+vec2 PointAt(int i)
+{
+    i = clamp(i, 0, int(pointCount) - 1);
+    return vec2(points[i], points[heightOffset + uint(i)]) * 2.0 - 1.0;
+}
+
+// Two vertices per point: the curve and the bottom for the fill, the curve's two
+// edges for the line
+void main()
+{
+    int point = gl_VertexID / 2;
+    bool isUpper = (gl_VertexID & 1) == 0;
+    vec2 p = PointAt(point);
+    if (isFill) {
+        gl_Position = vec4(p.x, isUpper ? p.y : -1.0, 0.0, 1.0);
+        return;
+    }
+
+    vec2 toPixels = viewportSize * 0.5;
+    vec2 direction = (PointAt(point + 1) - PointAt(point - 1)) * toPixels;
+    vec2 tangent = length(direction) > 0.0 ? normalize(direction) : vec2(1.0, 0.0);
+    vec2 normal = vec2(-tangent.y, tangent.x);
+    gl_Position = vec4(p + normal * (isUpper ? 0.5 : -0.5) * lineWidth / toPixels, 0.0, 1.0);
+}
+)" };
+
+static constexpr const char* FRAGMENT_SHADER{ R"(
+#version 460 core
+
+layout(location = 5) uniform vec4 color;
+
+out vec4 fragmentColor;
+
+void main()
+{
+    fragmentColor = color;
+}
+)" };
+
+enum Uniform : GLint {
+    UNIFORM_POINT_COUNT,
+    UNIFORM_HEIGHT_OFFSET,
+    UNIFORM_VIEWPORT_SIZE,
+    UNIFORM_LINE_WIDTH,
+    UNIFORM_IS_FILL,
+    UNIFORM_COLOR
+};
+
+void WaitFence(void*& fence)
+{
+    if (!fence)
+        return;
+    const auto sync{ static_cast<GLsync>(fence) };
+    GLenum result{};
+    do {
+        result = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000'000);
+    } while (result == GL_TIMEOUT_EXPIRED);
+    glDeleteSync(sync);
+    fence = nullptr;
+}
+
+}
+
+SpectrumRenderer::SpectrumRenderer(uint32_t channelCount) :
+    channelCount{ channelCount }
+{
+    program = CreateShaderProgram(VERTEX_SHADER, FRAGMENT_SHADER);
+
+    // Vertices are pulled from the storage buffer, but core profile draws need a vertex array
+    glCreateVertexArrays(1, &vertexArray);
+
+    GLint alignment{};
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    const uint32_t size{ (1 + channelCount) * MAX_POINTS * static_cast<uint32_t>(sizeof(float)) };
+    regionSize = (size + alignment - 1) / alignment * alignment;
+
+    static constexpr GLbitfield flags{ GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT };
+    glCreateBuffers(1, &buffer);
+    glNamedBufferStorage(buffer, REGION_COUNT * regionSize, nullptr, flags);
+    mapped = static_cast<uint8_t*>(glMapNamedBufferRange(buffer, 0, REGION_COUNT * regionSize, flags));
+    if (!mapped)
+        throw std::runtime_error{ "Could not map spectrum buffer\n" };
+}
+
+SpectrumRenderer::~SpectrumRenderer()
+{
+    for (auto& region : regions)
+        WaitFence(region.fence);
+    glUnmapNamedBuffer(buffer);
+    glDeleteBuffers(1, &buffer);
+    glDeleteVertexArrays(1, &vertexArray);
+    glDeleteProgram(program);
+}
+
+void SpectrumRenderer::Write(const std::vector<float>& positions, const std::vector<std::vector<float>>& heights)
+{
+    // The back region is ours until it is swapped out, and no fence guards it any more
+    Region& region{ regions[back] };
+    region.pointCount = std::min(static_cast<uint32_t>(positions.size()), MAX_POINTS);
+    region.channelCount = std::min(static_cast<uint32_t>(heights.size()), channelCount);
+
+    auto dst{ reinterpret_cast<float*>(mapped + GetOffset(back)) };
+    std::memcpy(dst, positions.data(), region.pointCount * sizeof(float));
+    for (uint32_t channel{}; channel < region.channelCount; ++channel)
+        std::memcpy(dst + (1 + channel) * MAX_POINTS, heights[channel].data(), region.pointCount * sizeof(float));
+
+    back = middle.exchange(back | FRESH) & ~FRESH;
+}
+
+void SpectrumRenderer::Draw(ImVec2 min, ImVec2 max, const std::vector<ImVec4>& colors, bool isFirstOnTop, float lineWidth,
+                            float fillAlpha)
+{
+    // Only hand the front region back once the GPU is done with it
+    if (middle.load() & FRESH) {
+        WaitFence(regions[front].fence);
+        front = middle.exchange(front) & ~FRESH;
+    }
+    Region& region{ regions[front] };
+    if (region.pointCount < 2)
+        return;
+
+    // ImGui's origin is the top left, GL's the bottom left
+    const auto& io{ ImGui::GetIO() };
+    const ImVec2 scale{ io.DisplayFramebufferScale };
+    const GLint width{ static_cast<GLint>((max.x - min.x) * scale.x) };
+    const GLint height{ static_cast<GLint>((max.y - min.y) * scale.y) };
+    glViewport(static_cast<GLint>(min.x * scale.x), static_cast<GLint>((io.DisplaySize.y - max.y) * scale.y), width, height);
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glUseProgram(program);
+    glBindVertexArray(vertexArray);
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, buffer, GetOffset(front), regionSize);
+
+    glUniform1ui(UNIFORM_POINT_COUNT, region.pointCount);
+    glUniform2f(UNIFORM_VIEWPORT_SIZE, static_cast<float>(width), static_cast<float>(height));
+    glUniform1f(UNIFORM_LINE_WIDTH, lineWidth * scale.x);
+
+    const auto vertexCount{ static_cast<GLsizei>(2 * region.pointCount) };
+    for (uint32_t i{}; i < region.channelCount; ++i) {
+        const uint32_t channel{ isFirstOnTop ? region.channelCount - 1 - i : i };
+        const ImVec4 color{ colors[channel] };
+        glUniform1ui(UNIFORM_HEIGHT_OFFSET, (1 + channel) * MAX_POINTS);
+
+        if (fillAlpha > 0) {
+            glUniform1i(UNIFORM_IS_FILL, GL_TRUE);
+            glUniform4f(UNIFORM_COLOR, color.x, color.y, color.z, fillAlpha);
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, vertexCount);
+        }
+        glUniform1i(UNIFORM_IS_FILL, GL_FALSE);
+        glUniform4f(UNIFORM_COLOR, color.x, color.y, color.z, 1.f);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, vertexCount);
+    }
+
+    glBindVertexArray(0);
+    glUseProgram(0);
+
+    // Drawn again next time unless a fresh frame arrives, so the fence is replaced each time
+    if (region.fence)
+        glDeleteSync(static_cast<GLsync>(region.fence));
+    region.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Config.h"
+
+#include <imgui.h>
+
+#include <cstdint>
+#include <vector>
+#include <atomic>
+
+// Draws the spectrum curve and fill with OpenGL 4.6, straight from the engine's frames.
+//
+// Frames go into one persistently mapped buffer split into three regions: the analysis
+// thread writes the back region and swaps it with the middle one, the render thread
+// swaps a fresh middle region in and draws it. A region only goes back to the writer
+// once the fence after its last draw has signaled. The engine already mapped the points
+// onto the plot's axes, so the vertex shader only reads them from the buffer and expands
+// them into triangle strips; the CPU never builds vertices.
+class SpectrumRenderer
+{
+public:
+    // Points per channel a region holds; the rest of a larger frame is not drawn
+    static constexpr uint32_t MAX_POINTS{ MAX_FFT_SIZE / 2 };
+
+public:
+    explicit SpectrumRenderer(uint32_t channelCount);
+    ~SpectrumRenderer();
+
+    // Called on the analysis thread, see SpectrumEngine::SetPlotCallback()
+    void Write(const std::vector<float>& positions, const std::vector<std::vector<float>>& heights);
+
+    // Draws the newest frame into the screen rectangle `min`..`max`, in ImGui coordinates.
+    // The first channel is drawn last, and so on top, unless `isFirstOnTop` is false.
+    void Draw(ImVec2 min, ImVec2 max, const std::vector<ImVec4>& colors, bool isFirstOnTop, float lineWidth, float fillAlpha);
+
+private:
+    static constexpr uint32_t REGION_COUNT{ 3 };
+    static constexpr uint32_t FRESH{ 1u << 31 };  // Set on the middle region when it holds an undrawn frame
+
+    struct Region {
+        uint32_t pointCount{};
+        uint32_t channelCount{};
+        void*    fence{};  // GLsync
+    };
+
+    uint32_t GetOffset(uint32_t region) const { return region * regionSize; }
+
+private:
+    const uint32_t channelCount;
+    uint32_t       regionSize{};  // Bytes, rounded up to the storage buffer alignment
+
+    uint32_t program{};
+    uint32_t vertexArray{};
+    uint32_t buffer{};
+    uint8_t* mapped{};
+
+    Region                regions[REGION_COUNT]{};
+    uint32_t              back{ 0 };   // Analysis thread only
+    std::atomic<uint32_t> middle{ 1 };
+    uint32_t              front{ 2 };  // Render thread only
+};
@@ -0,0 +1,182 @@
+#include "WaterfallRenderer.h"
+#include "Shader.h"
+
+#include <glad/glad.h>
+#include <implot.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+static constexpr const char* VERTEX_SHADER{ R"(
+#version 460 core
+
+out vec2 uv;
+
+// A quad over the viewport from four strip vertices, v = 0 at the top
+void main()
+{
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    uv = vec2(corner.x, 1.0 - corner.y);
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+}
+)" };
+
+static constexpr const char* FRAGMENT_SHADER{ R"(
+#version 460 core
+
+layout(binding = 0) uniform sampler2D levels;
+layout(binding = 1) uniform sampler2D colormap;
+
+layout(location = 0) uniform float newestRow;
+layout(location = 1) uniform float rowCount;
+
+in vec2 uv;
+out vec4 fragmentColor;
+
+// Rows wrap around, so scrolling is only a matter of where to start
+void main()
+{
+    float row = newestRow + 0.5 - uv.y * rowCount;
+    float level = texture(levels, vec2(uv.x, row / rowCount)).r;
+    fragmentColor = texture(colormap, vec2(level, 0.5));
+}
+)" };
+
+enum Uniform : GLint {
+    UNIFORM_NEWEST_ROW,
+    UNIFORM_ROW_COUNT
+};
+
+static constexpr uint32_t COLORMAP_SIZE{ 256 };
+
+}
+
+WaterfallRenderer::WaterfallRenderer()
+{
+    program = CreateShaderProgram(VERTEX_SHADER, FRAGMENT_SHADER);
+    glCreateVertexArrays(1, &vertexArray);
+
+    // Levels index the colormap directly, level 0 being the bottom of the plot
+    std::vector<ImVec4> colors(COLORMAP_SIZE);
+    for (uint32_t i{}; i < COLORMAP_SIZE; ++i)
+        colors[i] = ImPlot::SampleColormap(static_cast<float>(i) / (COLORMAP_SIZE - 1), ImPlotColormap_Viridis);
+    glCreateTextures(GL_TEXTURE_2D, 1, &colormap);
+    glTextureStorage2D(colormap, 1, GL_RGBA8, COLORMAP_SIZE, 1);
+    glTextureSubImage2D(colormap, 0, 0, 0, COLORMAP_SIZE, 1, GL_RGBA, GL_FLOAT, colors.data());
+    glTextureParameteri(colormap, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTextureParameteri(colormap, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTextureParameteri(colormap, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+
+    static constexpr GLbitfield flags{ GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT };
+    glCreateBuffers(1, &rowBuffer);
+    glNamedBufferStorage(rowBuffer, ROW_SLOTS * MAX_WIDTH, nullptr, flags);
+    mapped = static_cast<uint8_t*>(glMapNamedBufferRange(rowBuffer, 0, ROW_SLOTS * MAX_WIDTH, flags));
+    if (!mapped)
+        throw std::runtime_error{ "Could not map waterfall buffer\n" };
+}
+
+WaterfallRenderer::~WaterfallRenderer()
+{
+    if (fence) {
+        glClientWaitSync(static_cast<GLsync>(fence), GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000'000);
+        glDeleteSync(static_cast<GLsync>(fence));
+    }
+    glUnmapNamedBuffer(rowBuffer);
+    glDeleteBuffers(1, &rowBuffer);
+    glDeleteTextures(1, &texture);
+    glDeleteTextures(1, &colormap);
+    glDeleteVertexArrays(1, &vertexArray);
+    glDeleteProgram(program);
+}
+
+void WaterfallRenderer::Write(const std::vector<uint8_t>& levels)
+{
+    const uint64_t row{ written.load(std::memory_order_relaxed) };
+    if (levels.empty() || row - released.load(std::memory_order_acquire) >= ROW_SLOTS)
+        return;
+
+    const uint32_t slot{ static_cast<uint32_t>(row % ROW_SLOTS) };
+    rowWidths[slot] = std::min(static_cast<uint32_t>(levels.size()), MAX_WIDTH);
+    std::memcpy(mapped + slot * MAX_WIDTH, levels.data(), rowWidths[slot]);
+    written.store(row + 1, std::memory_order_release);
+}
+
+void WaterfallRenderer::Upload()
+{
+    // Slots go back to the writer once the GPU has read them
+    if (fence && glClientWaitSync(static_cast<GLsync>(fence), 0, 0) != GL_TIMEOUT_EXPIRED) {
+        glDeleteSync(static_cast<GLsync>(fence));
+        fence = nullptr;
+        released.store(fencedUpTo, std::memory_order_release);
+    }
+
+    const uint64_t end{ written.load(std::memory_order_acquire) };
+    if (uploaded == end)
+        return;
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, rowBuffer);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (; uploaded < end; ++uploaded) {
+        const uint32_t slot{ static_cast<uint32_t>(uploaded % ROW_SLOTS) };
+
+        // A new plot width starts the history over
+        if (rowWidths[slot] != textureWidth)
+            CreateTexture(rowWidths[slot]);
+
+        newestRow = (newestRow + 1) % HISTORY_SIZE;
+        glTextureSubImage2D(texture, 0, 0, newestRow, textureWidth, 1, GL_RED, GL_UNSIGNED_BYTE,
+                            reinterpret_cast<const void*>(static_cast<uintptr_t>(slot * MAX_WIDTH)));
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (!fence) {
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        fencedUpTo = uploaded;
+    }
+}
+
+void WaterfallRenderer::CreateTexture(uint32_t width)
+{
+    glDeleteTextures(1, &texture);
+    glCreateTextures(GL_TEXTURE_2D, 1, &texture);
+    glTextureStorage2D(texture, 1, GL_R8, width, HISTORY_SIZE);
+    glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+    const uint8_t silence{};
+    glClearTexImage(texture, 0, GL_RED, GL_UNSIGNED_BYTE, &silence);
+    textureWidth = width;
+    newestRow = HISTORY_SIZE - 1;
+}
+
+void WaterfallRenderer::Draw(ImVec2 min, ImVec2 max)
+{
+    if (!texture)
+        return;
+
+    // ImGui's origin is the top left, GL's the bottom left
+    const auto& io{ ImGui::GetIO() };
+    const ImVec2 scale{ io.DisplayFramebufferScale };
+    glViewport(static_cast<GLint>(min.x * scale.x), static_cast<GLint>((io.DisplaySize.y - max.y) * scale.y),
+               static_cast<GLint>((max.x - min.x) * scale.x), static_cast<GLint>((max.y - min.y) * scale.y));
+
+    glDisable(GL_BLEND);
+    glUseProgram(program);
+    glBindVertexArray(vertexArray);
+    glBindTextureUnit(0, texture);
+    glBindTextureUnit(1, colormap);
+    glUniform1f(UNIFORM_NEWEST_ROW, static_cast<float>(newestRow));
+    glUniform1f(UNIFORM_ROW_COUNT, static_cast<float>(HISTORY_SIZE));
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    glBindTextureUnit(0, 0);
+    glBindTextureUnit(1, 0);
+    glBindVertexArray(0);
+    glUseProgram(0);
+}
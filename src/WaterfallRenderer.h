@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Config.h"
+
+#include <imgui.h>
+
+#include <cstdint>
+#include <vector>
+#include <atomic>
+
+// Scrolling spectrogram of the engine's waterfall rows (SpectrumEngine::Frame::levels).
+//
+// The texture is a ring of rows: every frame uploads exactly one row over the oldest,
+// and the fragment shader scrolls by starting its lookup at the newest row, so nothing
+// is moved however long the history. The analysis thread writes rows into a
+// persistently mapped pixel buffer, and the render thread uploads them from there.
+class WaterfallRenderer
+{
+public:
+    static constexpr uint32_t HISTORY_SIZE{ 512 };   // Rows shown
+    static constexpr uint32_t MAX_WIDTH{ 8192 };     // Columns a row keeps
+
+public:
+    WaterfallRenderer();
+    ~WaterfallRenderer();
+
+    // Called on the analysis thread; the row is dropped while the render thread is behind
+    void Write(const std::vector<uint8_t>& levels);
+
+    // Moves the rows written since the last call into the history. Called every frame,
+    // drawn or not, so the writer never runs out of slots while the view is hidden.
+    void Upload();
+
+    // Draws the history into the screen rectangle `min`..`max`, in ImGui coordinates,
+    // newest row at the top.
+    void Draw(ImVec2 min, ImVec2 max);
+
+private:
+    static constexpr uint32_t ROW_SLOTS{ 64 };  // Rows in flight between the two threads
+
+    void CreateTexture(uint32_t width);
+
+private:
+    uint32_t program{};
+    uint32_t vertexArray{};
+    uint32_t colormap{};
+    uint32_t texture{};
+    uint32_t textureWidth{};
+    uint32_t newestRow{ HISTORY_SIZE - 1 };
+
+    uint32_t rowBuffer{};
+    uint8_t* mapped{};
+    uint32_t rowWidths[ROW_SLOTS]{};
+
+    // Rows written by the analysis thread, and those whose upload the GPU has finished;
+    // the slots in between are not to be touched by the writer
+    std::atomic<uint64_t> written{};
+    std::atomic<uint64_t> released{};
+    uint64_t              uploaded{};
+    uint64_t              fencedUpTo{};
+    void*                 fence{};  // GLsync
+};
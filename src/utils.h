@@ -22,16 +22,3 @@ template <typename F>
 Deferrer<F> defer_func(F f) {
 	return Deferrer<F>(f);
 }
-
-static inline SP_FLOAT FastMag(const std::complex<SP_FLOAT>& c)
-{
-    SP_FLOAT absRe{ SP_ABS(c.real()) };
-    SP_FLOAT absIm{ SP_ABS(c.imag()) };
-    SP_FLOAT max{ std::max(absRe, absIm) };
-    SP_FLOAT min{ std::min(absRe, absIm) };
-	return max + 3 * min / 8;
-}
-
-
-
-